@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <cml/cml.hh>
+
+using namespace cml;
+
+using Timeholder = double;
+
+// Keeps benchmarked results observable so the calls are not optimized away
+inline volatile Uint64 benchmarkSink = 0;
+
+/**
+ * \brief Average duration of one call
+ * \param repeatCount How many times to call \a function
+ * \param function Callable returning the computed value
+ * \return Microseconds per call
+ */
+template <class Function>
+Timeholder measure(std::size_t repeatCount, Function&& function)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (std::size_t i = 0; i < repeatCount; ++i) {
+        auto result = function();
+        benchmarkSink ^= static_cast<Uint64>(result & 0xFFFF);
+    }
+
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration<Timeholder, std::micro>(stop - start).count() / static_cast<Timeholder>(repeatCount);
+}
+
+inline void printHeader(const std::string& title, const std::string& baseline, const std::string& candidate)
+{
+    std::cout << std::endl
+              << title << std::endl
+              << std::left << std::setw(12) << "bits" << std::setw(24) << (baseline + " (us)") << std::setw(24)
+              << (candidate + " (us)") << "speedup" << std::endl;
+}
+
+inline void printRow(Uint32 bitness, Timeholder baseline, Timeholder candidate)
+{
+    std::cout << std::left << std::fixed << std::setprecision(2) << std::setw(12) << bitness << std::setw(24)
+              << baseline << std::setw(24) << candidate << (baseline / candidate) << "x" << std::endl;
+}
\ No newline at end of file
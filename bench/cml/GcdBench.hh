@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+
+#include "Benchmark.hh"
+
+// The recursive extended Euclid gcdex used to be, one full division and one frame per quotient
+template <typename T>
+T recursiveGcdex(const T& a, const T& b, T& x, T& y)
+{
+    if (a == 0) {
+        x = 0;
+        y = 1;
+        return b;
+    }
+    T x1, y1;
+    T d = recursiveGcdex<T>(b % a, a, x1, y1);
+    x   = y1 - (b / a) * x1;
+    y   = x1;
+    return d;
+}
+
+template <Uint32 bitness>
+void benchGcdex(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, UnboundedInt> randomGenerator{};
+
+    std::vector<UnboundedInt> as{}, bs{};
+    for (std::size_t i = 0; i < 64; ++i) {
+        as.push_back(randomGenerator());
+        bs.push_back(randomGenerator() | 1);
+    }
+
+    std::size_t recursiveIndex = 0, lehmerIndex = 0;
+    UnboundedInt x{}, y{};
+
+    Timeholder recursive = measure(repeatCount, [&] {
+        const std::size_t i = recursiveIndex++ & 63;
+        return recursiveGcdex(as[i], bs[i], x, y) + x;
+    });
+    Timeholder lehmer = measure(repeatCount, [&] {
+        const std::size_t i = lehmerIndex++ & 63;
+        return gcdex(as[i], bs[i], x, y) + x;
+    });
+
+    printRow(bitness, recursive, lehmer);
+}
+
+template <Uint32 bitness>
+void benchInvmodBatch(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, UnboundedInt> randomGenerator{};
+
+    const UnboundedInt modulus = randomGenerator() | 1 | (UnboundedInt{ 1 } << (bitness - 1));
+    std::vector<UnboundedInt> values{};
+    while (values.size() < 100) {
+        UnboundedInt value = randomGenerator() % modulus;
+        if (cml::gcd(value, modulus) == 1)
+            values.push_back(std::move(value));
+    }
+
+    // 100 inverses per call
+    Timeholder separate = measure(repeatCount, [&] {
+        UnboundedInt sum = 0;
+        for (auto&& value : values) {
+            sum += invmod(value, modulus);
+        }
+        return sum;
+    });
+    Timeholder batch = measure(repeatCount, [&] { return invmodBatch(values, modulus).inverses.back(); });
+
+    printRow(bitness, separate, batch);
+}
+
+inline void benchGcd()
+{
+    printHeader("gcdex: random operands, recursive Euclid vs Lehmer", "recursive", "lehmer");
+    benchGcdex<512>(2000);
+    benchGcdex<1024>(1000);
+    benchGcdex<2048>(300);
+    benchGcdex<4096>(100);
+
+    printHeader("100 inverses modulo one modulus: invmod each vs invmodBatch", "invmod", "batch");
+    benchInvmodBatch<256>(200);
+    benchInvmodBatch<1024>(50);
+    benchInvmodBatch<2048>(20);
+    benchInvmodBatch<4096>(5);
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "Benchmark.hh"
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchModexpReduction(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    Value modulus = randomGenerator() | 1;
+    modulus |= Value{ 1 } << (bitness - 1);
+    Value base = randomGenerator() % modulus;
+    Value exp  = randomGenerator();
+
+    // Contexts are built inside the timed call, as modexp does
+    Timeholder division = measure(repeatCount, [&] { return DivisionContext<Value>{ modulus }.modexp(base, exp); });
+    Timeholder montgomery =
+        measure(repeatCount, [&] { return MontgomeryContext<Value>{ modulus }.modexp(base, exp); });
+
+    printRow(bitness, division, montgomery);
+}
+
+template <typename Value>
+void benchWordReduction(std::size_t repeatCount)
+{
+    constexpr Uint32 bitness = std::numeric_limits<Value>::digits;
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    // Fresh operands every call, a constant call would be hoisted out of the loop
+    std::vector<Value> moduli{}, bases{}, exps{};
+    for (std::size_t i = 0; i < 256; ++i) {
+        moduli.push_back(randomGenerator() | 1 | (Value{ 1 } << (bitness - 1)));
+        bases.push_back(randomGenerator());
+        exps.push_back(randomGenerator());
+    }
+
+    std::size_t division = 0, word = 0;
+    Timeholder divisionTime = measure(repeatCount, [&] {
+        const std::size_t i = division++ & 255;
+        return DivisionContext<Value>{ moduli[i] }.modexp(bases[i], exps[(i * 7) & 255]);
+    });
+    Timeholder wordTime = measure(repeatCount, [&] {
+        const std::size_t i = word++ & 255;
+        return WordMontgomeryContext<Value>{ moduli[i] }.modexp(bases[i], exps[(i * 7) & 255]);
+    });
+
+    printRow(bitness, divisionTime, wordTime);
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchExponentWindow(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    Value modulus = randomGenerator() | 1;
+    modulus |= Value{ 1 } << (bitness - 1);
+    Value exp = randomGenerator() | (Value{ 1 } << (bitness - 1));
+
+    MontgomeryContext<Value> context{ modulus };
+    auto base = context.toResidue(randomGenerator());
+
+    Timeholder binary  = measure(repeatCount, [&] { return detail::binaryPower(context, base, exp)[0]; });
+    Timeholder sliding = measure(repeatCount, [&] { return detail::power(context, base, exp)[0]; });
+
+    printRow(bitness, binary, sliding);
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchFixedBase(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    Value modulus = randomGenerator() | 1;
+    modulus |= Value{ 1 } << (bitness - 1);
+    Value base = 2;
+    Value exp  = randomGenerator();
+
+    MontgomeryContext<Value> context{ modulus };
+    FixedBaseExponentiator<Value> exponentiator{ base, modulus, bitness };
+
+    Timeholder window = measure(repeatCount, [&] { return context.modexp(base, exp); });
+    Timeholder comb   = measure(repeatCount, [&] { return exponentiator.modexp(exp); });
+
+    printRow(bitness, window, comb);
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchMultiExp(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    Value modulus = randomGenerator() | 1;
+    modulus |= Value{ 1 } << (bitness - 1);
+    Value a = randomGenerator(), x = randomGenerator();
+    Value b = randomGenerator(), y = randomGenerator();
+
+    Timeholder separate = measure(repeatCount, [&] {
+        using Wide = typename ExtendedContainer<Value>::Type;
+        return static_cast<Value>(Wide{ modexp(a, x, modulus) } * modexp(b, y, modulus) % modulus);
+    });
+    Timeholder interleaved = measure(repeatCount, [&] { return multiExp(a, x, b, y, modulus); });
+
+    printRow(bitness, separate, interleaved);
+}
+
+template <Uint32 bitness>
+void benchWorkspace(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, UnboundedInt> randomGenerator{};
+
+    const UnboundedInt modulus = randomGenerator() | 1 | (UnboundedInt{ 1 } << (bitness - 1));
+    const UnboundedInt base    = randomGenerator() % modulus;
+    const UnboundedInt exp     = 65537;
+
+    Workspace<UnboundedInt> workspace{};
+    UnboundedInt result{};
+
+    Timeholder plain  = measure(repeatCount, [&] { return modexp(base, exp, modulus); });
+    Timeholder reused  = measure(repeatCount, [&] {
+        modexp(result, base, exp, modulus, workspace);
+        return static_cast<Uint64>(result & 0xFFFF);
+    });
+
+    printRow(bitness, plain, reused);
+}
+
+inline void benchModexp()
+{
+    printHeader("modexp: full-width exponent, division vs Montgomery reduction", "division", "montgomery");
+    benchModexpReduction<64>(20000);
+    benchModexpReduction<128>(10000);
+    benchModexpReduction<256>(2000);
+    benchModexpReduction<512>(200);
+    benchModexpReduction<1024>(50);
+    benchModexpReduction<2048>(10);
+
+    printHeader("modexp: built-in types, division vs single-word Montgomery", "division", "word");
+    benchWordReduction<Uint32>(200000);
+    benchWordReduction<Uint64>(200000);
+
+    printHeader("modexp: e = 65537 on one modulus, plain vs workspace", "plain", "workspace");
+    benchWorkspace<1024>(5000);
+    benchWorkspace<2048>(2000);
+    benchWorkspace<4096>(500);
+
+    printHeader("modexp: full-width exponent, binary vs sliding window (Montgomery)", "binary", "sliding");
+    benchExponentWindow<512>(200);
+    benchExponentWindow<1024>(50);
+    benchExponentWindow<2048>(10);
+    benchExponentWindow<4096>(3);
+
+    printHeader("g^x: sliding window vs fixed-base comb (8 rows, 2 columns)", "window", "comb");
+    benchFixedBase<512>(200);
+    benchFixedBase<1024>(50);
+    benchFixedBase<2048>(10);
+    benchFixedBase<3072>(5);
+
+    printHeader("a^x * b^y: two modexp vs multiExp", "separate", "multiExp");
+    benchMultiExp<512>(100);
+    benchMultiExp<1024>(30);
+    benchMultiExp<2048>(5);
+}
\ No newline at end of file
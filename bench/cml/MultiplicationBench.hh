@@ -0,0 +1,150 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "Benchmark.hh"
+
+// binpow as it was, cpp_int products only
+inline UnboundedInt plainBinpow(Uint64 number, Uint64 power)
+{
+    UnboundedInt res = 1;
+    UnboundedInt a   = number;
+    while (power != 0) {
+        if ((power & 1) == 1)
+            res *= a;
+        a *= a;
+        power >>= 1;
+    }
+    return res;
+}
+
+template <Uint32 bitness>
+void benchMulLarge(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, UnboundedInt> randomGenerator{};
+
+    const UnboundedInt a = randomGenerator(), b = randomGenerator();
+    std::vector<Limb> aLimbs(limbLength(a)), bLimbs(limbLength(b)), product(aLimbs.size() + bLimbs.size());
+    detail::exportLimbs(a, aLimbs.data(), aLimbs.size());
+    detail::exportLimbs(b, bLimbs.data(), bLimbs.size());
+
+    Timeholder plain = measure(repeatCount, [&] { return UnboundedInt{ a * b }; });
+    Timeholder ntt   = measure(repeatCount, [&] {
+        detail::nttMultiplyLimbs(product.data(), aLimbs.data(), aLimbs.size(), bLimbs.data(), bLimbs.size());
+        return product[0];
+    });
+
+    printRow(bitness, plain, ntt);
+}
+
+// 3^power, the row shows the bit length of the result
+inline void benchBinpow(Uint64 power, std::size_t repeatCount)
+{
+    const Uint32 bits = bitLength(binpow<Uint64>(3, power));
+
+    Timeholder plain = measure(repeatCount, [&] { return plainBinpow(3, power); });
+    Timeholder large = measure(repeatCount, [&] { return binpow<Uint64>(3, power); });
+
+    printRow(bits, plain, large);
+}
+
+// channels odd primes right below 2^64
+inline std::vector<Limb> benchWordPrimes(std::size_t channels)
+{
+    std::vector<Limb> primes{};
+    for (Limb candidate = std::numeric_limits<Limb>::max(); primes.size() < channels; candidate -= 2) {
+        if (deterministicMillerRabinTest(candidate))
+            primes.push_back(candidate);
+    }
+    return primes;
+}
+
+inline void benchRnsMultiply(std::size_t channels, std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+
+    const ResidueNumberSystem rns{ benchWordPrimes(channels) };
+    const MontgomeryContext<UnboundedInt> context{ rns.modulus() };
+
+    UnboundedInt a = 0, b = 0;
+    for (std::size_t i = 0; i < channels; ++i) {
+        a = (a << 64) | randomGenerator();
+        b = (b << 64) | randomGenerator();
+    }
+    a %= rns.modulus();
+    b %= rns.modulus();
+
+    auto x = context.toResidue(a), y = context.toResidue(b), product = x;
+    auto u = rns.toResidue(a), v = rns.toResidue(b), rnsProduct = u;
+
+    Timeholder montgomery = measure(repeatCount, [&] {
+        context.multiply(product, x, y);
+        return product[0];
+    });
+    Timeholder channel = measure(repeatCount, [&] {
+        rns.multiply(rnsProduct, u, v);
+        return rnsProduct[0];
+    });
+
+    printRow(bitLength(rns.modulus()), montgomery, channel);
+}
+
+// Textbook CRT, sum of r_i * (M / m_i) * ((M / m_i)^-1 mod m_i) reduced modulo M, against Garner
+inline void benchRnsReconstruction(std::size_t channels, std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+
+    const ResidueNumberSystem rns{ benchWordPrimes(channels) };
+    const UnboundedInt& modulus = rns.modulus();
+
+    std::vector<UnboundedInt> weights{};
+    for (Limb prime : rns.moduli()) {
+        const UnboundedInt cofactor = modulus / prime;
+        weights.push_back(cofactor * invmod(static_cast<Limb>(cofactor % prime), prime));
+    }
+
+    UnboundedInt number = 0;
+    for (std::size_t i = 0; i < channels; ++i) {
+        number = (number << 64) | randomGenerator();
+    }
+    const auto residue = rns.toResidue(number % modulus);
+
+    Timeholder textbook = measure(repeatCount, [&] {
+        UnboundedInt sum = 0;
+        for (std::size_t i = 0; i < channels; ++i) {
+            sum += weights[i] * rns.channelValue(residue, i);
+        }
+        return UnboundedInt{ sum % modulus };
+    });
+    Timeholder garner = measure(repeatCount, [&] { return rns.fromResidue(residue); });
+
+    printRow(bitLength(modulus), textbook, garner);
+}
+
+inline void benchMultiplication()
+{
+    printHeader("a * b: equal random operands, cpp_int vs three-prime NTT", "cpp_int", "ntt");
+    benchMulLarge<16384>(200);
+    benchMulLarge<32768>(100);
+    benchMulLarge<65536>(50);
+    benchMulLarge<262144>(5);
+    benchMulLarge<1048576>(2);
+    benchMulLarge<4194304>(1);
+
+    printHeader("binpow(3, power): cpp_int products vs mulLarge", "cpp_int", "mulLarge");
+    benchBinpow(10000, 200);
+    benchBinpow(100000, 10);
+    benchBinpow(1000000, 2);
+    benchBinpow(4000000, 1);
+
+    printHeader("a * b mod M, M product of word primes: Montgomery vs RNS channels", "montgomery", "rns");
+    benchRnsMultiply(8, 20000);
+    benchRnsMultiply(32, 5000);
+    benchRnsMultiply(128, 1000);
+
+    printHeader("RNS to number: textbook CRT vs Garner", "crt", "garner");
+    benchRnsReconstruction(8, 20000);
+    benchRnsReconstruction(32, 2000);
+    benchRnsReconstruction(128, 200);
+}
\ No newline at end of file
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hh"
+
+// Accepting a prime: bitness random-base rounds, as the generators did, against Baillie-PSW
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchAcceptPrime(std::size_t repeatCount)
+{
+    using RandomGenerator = Mt19937RandomGenerator<bitness, Value>;
+
+    MilRabPrimeGenerator<bitness, RandomGenerator, Value, BailliePswPolicy> primeGenerator{};
+    RandomGenerator randomGenerator{};
+    const Value prime = primeGenerator();
+
+    Timeholder millerRabin = measure(repeatCount, [&] { return millerRabinTest(prime, bitness, randomGenerator); });
+    Timeholder baillie     = measure(repeatCount, [&] { return bailliePswTest(prime); });
+
+    printRow(bitness, millerRabin, baillie);
+}
+
+// Confirming a safe prime 2 * q + 1 of a known prime q: Miller-Rabin with bit length of q rounds vs Pocklington
+template <Uint32 bitness, typename Value = typename ContainerByBitness<2 * bitness>::Type>
+void benchConfirmSafePrime(std::size_t repeatCount)
+{
+    using PrimeValue     = typename ContainerByBitness<bitness>::Type;
+    using PrimeGenerator = MilRabPrimeGenerator<bitness, Mt19937RandomGenerator<bitness, PrimeValue>, PrimeValue>;
+
+    MilRabSafePrimeGenerator<PrimeGenerator, Mt19937RandomGenerator<2 * bitness, Value>, Value> safePrimeGenerator{};
+    Mt19937RandomGenerator<2 * bitness, Value> randomGenerator{};
+    const Value safePrime = safePrimeGenerator();
+
+    Timeholder millerRabin = measure(repeatCount, [&] { return millerRabinTest(safePrime, bitness, randomGenerator); });
+    Timeholder pocklington = measure(repeatCount, [&] { return pocklingtonSafePrimeTest(safePrime); });
+
+    printRow(bitness, millerRabin, pocklington);
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchGeneratePrime(std::size_t repeatCount)
+{
+    using RandomGenerator = Mt19937RandomGenerator<bitness, Value>;
+
+    MilRabPrimeGenerator<bitness, RandomGenerator, Value, MillerRabinPolicy> millerRabinGenerator{};
+    MilRabPrimeGenerator<bitness, RandomGenerator, Value, BailliePswPolicy> bailliePswGenerator{};
+
+    Timeholder millerRabin = measure(repeatCount, [&] { return millerRabinGenerator(); });
+    Timeholder baillie     = measure(repeatCount, [&] { return bailliePswGenerator(); });
+
+    printRow(bitness, millerRabin, baillie);
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchRoundPolicy(std::size_t repeatCount)
+{
+    using RandomGenerator = Mt19937RandomGenerator<bitness, Value>;
+
+    MilRabPrimeGenerator<bitness, RandomGenerator, Value, MillerRabinPolicy, BitLengthRounds> bitLengthGenerator{};
+    MilRabPrimeGenerator<bitness, RandomGenerator, Value, MillerRabinPolicy, ErrorBoundRounds<128>>
+        errorBoundGenerator{};
+
+    Timeholder bitLength  = measure(repeatCount, [&] { return bitLengthGenerator(); });
+    Timeholder errorBound = measure(repeatCount, [&] { return errorBoundGenerator(); });
+
+    printRow(bitness, bitLength, errorBound);
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchSearchPolicy(std::size_t repeatCount)
+{
+    using RandomGenerator = Mt19937RandomGenerator<bitness, Value>;
+
+    MilRabPrimeGenerator<bitness, RandomGenerator, Value, MillerRabinPolicy, ErrorBoundRounds<128>, RandomSearch>
+        randomGenerator{};
+    MilRabPrimeGenerator<bitness, RandomGenerator, Value, MillerRabinPolicy, ErrorBoundRounds<128>, SieveSearch>
+        sieveGenerator{};
+
+    Timeholder random = measure(repeatCount, [&] { return randomGenerator(); });
+    Timeholder sieve  = measure(repeatCount, [&] { return sieveGenerator(); });
+
+    printRow(bitness, random, sieve);
+}
+
+// Safe primes of bitness + 1 bits: 2 * q + 1 for q of the prime generator vs the double sieve over q
+template <Uint32 bitness, typename Value = typename ContainerByBitness<2 * bitness>::Type>
+void benchSafePrimeSearch(std::size_t repeatCount)
+{
+    using PrimeValue      = typename ContainerByBitness<bitness>::Type;
+    using PrimeGenerator  = MilRabPrimeGenerator<bitness, Mt19937RandomGenerator<bitness, PrimeValue>, PrimeValue>;
+    using RandomGenerator = Mt19937RandomGenerator<2 * bitness, Value>;
+
+    MilRabSafePrimeGenerator<PrimeGenerator,
+                             RandomGenerator,
+                             Value,
+                             MillerRabinPolicy,
+                             ErrorBoundRounds<128>,
+                             InnerGeneratorSearch>
+        innerGenerator{};
+    MilRabSafePrimeGenerator<PrimeGenerator, RandomGenerator, Value> sieveGenerator{};
+
+    Timeholder inner = measure(repeatCount, [&] { return innerGenerator(); });
+    Timeholder sieve = measure(repeatCount, [&] { return sieveGenerator(); });
+
+    printRow(bitness, inner, sieve);
+}
+
+// Exact tests of a batch of random odd words: constexpr division-based modexp vs word Montgomery
+template <typename Word>
+void benchExactWordTest(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    std::vector<Word> numbers(1000);
+    for (Word& number : numbers) {
+        number = static_cast<Word>(randomGenerator()) | 1;
+    }
+
+    const auto count = [&](auto test) {
+        std::size_t primes = 0;
+        for (Word number : numbers) {
+            primes += test(number) ? 1 : 0;
+        }
+        return primes;
+    };
+
+    Timeholder division   = measure(repeatCount, [&] { return count(deterministicMillerRabinTest<Word>); });
+    Timeholder montgomery = measure(repeatCount, [&] { return count(isPrime64); });
+
+    printRow(8 * sizeof(Word), division, montgomery);
+}
+
+// 1000 odd words, every one prime or random
+inline void benchBatchTest(bool primes, std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    std::vector<Uint64> numbers{};
+    for (Uint64 number = 18446744073709551615ull; primes && numbers.size() < 1000; number -= 2) {
+        if (isPrime64(number))
+            numbers.push_back(number);
+    }
+    while (numbers.size() < 1000) {
+        numbers.push_back(randomGenerator() | 1);
+    }
+
+    const std::unique_ptr<bool[]> results = std::make_unique<bool[]>(numbers.size());
+
+    Timeholder single = measure(repeatCount, [&] {
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            results[i] = isPrime64(numbers[i]);
+        }
+        return results[0];
+    });
+    Timeholder batch = measure(repeatCount, [&] {
+        millerRabinBatch(numbers.data(), results.get(), numbers.size());
+        return results[0];
+    });
+
+    printRow(primes ? 1 : 0, single, batch);
+}
+
+// 1024 random odd candidates of 1024 bits: trial division by each prime in turn vs the remainder tree
+inline void benchBatchTrialDivision(std::size_t primeCount, std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<1024, Uint1024> randomGenerator{};
+    std::vector<Uint1024> candidates(1024);
+    for (Uint1024& candidate : candidates) {
+        candidate = randomGenerator() | 1;
+    }
+
+    const BatchTrialDivision division{ primeCount };
+
+    Timeholder single = measure(repeatCount, [&] {
+        std::size_t survivors = 0;
+        for (const Uint1024& candidate : candidates) {
+            bool divided = false;
+            for (Uint32 prime : division.primes()) {
+                if (candidate % prime == 0) {
+                    divided = true;
+                    break;
+                }
+            }
+            survivors += divided ? 0 : 1;
+        }
+        return survivors;
+    });
+    Timeholder tree = measure(repeatCount, [&] { return division.survivors(candidates).size(); });
+
+    printRow(static_cast<Uint32>(primeCount), single, tree);
+}
+
+// Accepting a prime: rounds one after another vs spread over the hardware threads
+template <Uint32 bitness>
+void benchParallelRounds(Uint32 rounds, std::size_t repeatCount)
+{
+    using RandomGenerator = Mt19937RandomGenerator<bitness, UnboundedInt>;
+
+    MilRabPrimeGenerator<bitness, RandomGenerator, UnboundedInt, BailliePswPolicy> primeGenerator{};
+    RandomGenerator randomGenerator{};
+    const UnboundedInt prime = primeGenerator();
+
+    Timeholder sync     = measure(repeatCount, [&] { return millerRabinTest(prime, rounds, randomGenerator); });
+    Timeholder parallel = measure(repeatCount, [&] {
+        return millerRabinTest(prime, rounds, randomGenerator, LaunchPolicy::Parallel);
+    });
+
+    printRow(bitness, sync, parallel);
+}
+
+// Primes below 10^exponent: isPrime64 of every odd number vs the segmented sieve
+inline void benchPrimeSieve(Uint32 exponent, std::size_t repeatCount)
+{
+    Uint64 limit = 1;
+    for (Uint32 i = 0; i < exponent; ++i) {
+        limit *= 10;
+    }
+
+    Timeholder single = measure(repeatCount, [&] {
+        Uint64 primes = 1;
+        for (Uint64 number = 3; number < limit; number += 2) {
+            primes += isPrime64(number) ? 1 : 0;
+        }
+        return primes;
+    });
+    Timeholder sieve = measure(repeatCount, [&] { return countPrimes(0, limit); });
+
+    printRow(exponent, single, sieve);
+}
+
+// Latency of one prime: a single search vs one per hardware thread
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchParallelSearch(std::size_t repeatCount)
+{
+    MilRabPrimeGenerator<bitness, Mt19937RandomGenerator<bitness, Value>, Value> primeGenerator{};
+
+    Timeholder sync     = measure(repeatCount, [&] { return primeGenerator(LaunchPolicy::Sync); });
+    Timeholder parallel = measure(repeatCount, [&] { return primeGenerator(LaunchPolicy::Parallel); });
+
+    printRow(bitness, sync, parallel);
+}
+
+// Latency of one safe prime: the double sieve on one thread vs the pipeline on every hardware thread
+template <Uint32 bitness, typename Value = typename ContainerByBitness<2 * bitness>::Type>
+void benchPipelinedSafePrime(std::size_t repeatCount)
+{
+    using PrimeValue     = typename ContainerByBitness<bitness>::Type;
+    using PrimeGenerator = MilRabPrimeGenerator<bitness, Mt19937RandomGenerator<bitness, PrimeValue>, PrimeValue>;
+
+    MilRabSafePrimeGenerator<PrimeGenerator, Mt19937RandomGenerator<2 * bitness, Value>, Value> safePrimeGenerator{};
+
+    Timeholder sync      = measure(repeatCount, [&] { return safePrimeGenerator(LaunchPolicy::Sync); });
+    Timeholder pipelined = measure(repeatCount, [&] { return safePrimeGenerator.generatePipelined().get(); });
+
+    printRow(bitness, sync, pipelined);
+}
+
+// Latency of a request: generating inline vs popping from a full pool
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchPrimePool(std::size_t repeatCount)
+{
+    using PrimeGenerator = MilRabPrimeGenerator<bitness, Mt19937RandomGenerator<bitness, Value>, Value>;
+
+    PrimeGenerator primeGenerator{};
+    // One prime to spare, so no request of the measurement wakes the background thread
+    PrimePool<PrimeGenerator> primePool{ 1, repeatCount + 1 };
+    while (primePool.metrics().depth <= repeatCount) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+    }
+
+    Timeholder inlined = measure(repeatCount, [&] { return primeGenerator(); });
+    Timeholder pooled  = measure(repeatCount, [&] { return primePool(); });
+
+    printRow(bitness, inlined, pooled);
+}
+
+inline void benchPrimality()
+{
+    printHeader("accept a prime: bitness Miller-Rabin rounds vs Baillie-PSW", "miller-rabin", "baillie-psw");
+    benchAcceptPrime<128>(500);
+    benchAcceptPrime<256>(20);
+    benchAcceptPrime<512>(5);
+    benchAcceptPrime<1024>(1);
+
+    printHeader("confirm 2 * q + 1, rows by bit length of q: Miller-Rabin vs Pocklington", "miller-rabin",
+                "pocklington");
+    benchConfirmSafePrime<256>(20);
+    benchConfirmSafePrime<512>(5);
+
+    printHeader("1000 odd words: constexpr exact test vs isPrime64", "constexpr", "word-montgomery");
+    benchExactWordTest<Uint32>(50);
+    benchExactWordTest<Uint64>(50);
+
+    printHeader("1000 odd words, random (0) or prime (1): isPrime64 vs millerRabinBatch", "single", "batch");
+    benchBatchTest(false, 50);
+    benchBatchTest(true, 20);
+
+    printHeader("1024 candidates of 1024 bits, rows by prime count: trial division vs remainder tree", "trial",
+                "tree");
+    benchBatchTrialDivision(303, 5);
+    benchBatchTrialDivision(4096, 2);
+    benchBatchTrialDivision(65536, 1);
+
+    printHeader("8 Miller-Rabin rounds on a prime: Sync vs Parallel", "sync", "parallel");
+    benchParallelRounds<2048>(8, 2);
+    benchParallelRounds<4096>(8, 1);
+
+    printHeader("primes below 10^row: isPrime64 per number vs countPrimes", "single", "sieve");
+    benchPrimeSieve(6, 5);
+    benchPrimeSieve(7, 1);
+
+    printHeader("MilRabPrimeGenerator: bit length vs 2^-128 error bound rounds", "bit-length", "error-bound");
+    benchRoundPolicy<256>(20);
+    benchRoundPolicy<512>(5);
+    benchRoundPolicy<1024>(2);
+
+    printHeader("MilRabPrimeGenerator: fresh random candidates vs sieved incremental search", "random", "sieve");
+    benchSearchPolicy<256>(100);
+    benchSearchPolicy<512>(20);
+    benchSearchPolicy<1024>(5);
+
+    printHeader("MilRabSafePrimeGenerator, rows by bit length of q: inner generator vs double sieve", "inner",
+                "double-sieve");
+    benchSafePrimeSearch<256>(4);
+    benchSafePrimeSearch<512>(2);
+
+    printHeader("MilRabPrimeGenerator: one prime, Sync vs Parallel search", "sync", "parallel");
+    benchParallelSearch<1024>(10);
+    benchParallelSearch<2048>(2);
+
+    printHeader("MilRabSafePrimeGenerator, rows by bit length of q: Sync vs pipelined", "sync", "pipelined");
+    benchPipelinedSafePrime<512>(2);
+    benchPipelinedSafePrime<1024>(1);
+
+    printHeader("request latency: MilRabPrimeGenerator vs full PrimePool", "inline", "pool");
+    benchPrimePool<512>(16);
+    benchPrimePool<1024>(4);
+
+    printHeader("MilRabPrimeGenerator: Miller-Rabin vs Baillie-PSW policy", "miller-rabin", "baillie-psw");
+    benchGeneratePrime<256>(20);
+    benchGeneratePrime<512>(5);
+    benchGeneratePrime<1024>(2);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <initializer_list>
+
+#include "Benchmark.hh"
+
+// Context setup, conversion in and out and multiplications products of a random residue
+template <class Context, typename Value>
+Timeholder measureReuse(std::size_t repeatCount, const Value& modulus, const Value& number, std::size_t multiplications)
+{
+    return measure(repeatCount, [&] {
+        const Context context{ modulus };
+        auto x      = context.toResidue(number);
+        auto buffer = x;
+        for (std::size_t i = 0; i < multiplications; ++i) {
+            context.multiply(buffer, x, x);
+            std::swap(x, buffer);
+        }
+        return context.fromResidue(x);
+    });
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void benchReductionCrossover(std::size_t repeatCount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    Value modulus = randomGenerator() | 1;
+    modulus |= Value{ 1 } << (bitness - 1);
+    const Value number = randomGenerator() % modulus;
+
+    for (std::size_t multiplications : { 0, 1, 2, 4, 8, 16, 64, 256 }) {
+        const std::size_t repeats = repeatCount / (multiplications + 1) + 1;
+
+        Timeholder division   = measureReuse<DivisionContext<Value>>(repeats, modulus, number, multiplications);
+        Timeholder barrett    = measureReuse<BarrettContext<Value>>(repeats, modulus, number, multiplications);
+        Timeholder montgomery = measureReuse<MontgomeryContext<Value>>(repeats, modulus, number, multiplications);
+
+        const Reduction chosen = chooseReduction(modulus, multiplications);
+        std::cout << std::left << std::fixed << std::setprecision(2) << std::setw(8) << bitness << std::setw(8)
+                  << multiplications << std::setw(18) << division << std::setw(18) << barrett << std::setw(18)
+                  << montgomery
+                  << (chosen == Reduction::Division ? "division"
+                                                    : (chosen == Reduction::Barrett ? "barrett" : "montgomery"))
+                  << std::endl;
+    }
+}
+
+inline void benchReduction()
+{
+    std::cout << std::endl
+              << "reduction: setup, conversions and N multiplications per modulus" << std::endl
+              << std::left << std::setw(8) << "bits" << std::setw(8) << "N" << std::setw(18) << "division (us)"
+              << std::setw(18) << "barrett (us)" << std::setw(18) << "montgomery (us)"
+              << "chosen" << std::endl;
+
+    benchReductionCrossover<128>(20000);
+    benchReductionCrossover<256>(20000);
+    benchReductionCrossover<512>(10000);
+    benchReductionCrossover<1024>(5000);
+    benchReductionCrossover<2048>(2000);
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include "GcdBench.hh"
+#include "ModexpBench.hh"
+#include "MultiplicationBench.hh"
+#include "PrimalityBench.hh"
+#include "ReductionBench.hh"
+
+int main()
+{
+    benchModexp();
+    benchReduction();
+    benchGcd();
+    benchMultiplication();
+    benchPrimality();
+    return 0;
+}
\ No newline at end of file
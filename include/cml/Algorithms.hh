@@ -1,15 +1,33 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <random>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "BarrettContext.hh"
+#include "ConstexprArithmetic.hh"
+#include "DeterministicPrimality.hh"
+#include "DivisionContext.hh"
 #include "ExtendedContainer.hh"
 #include "IsRandomGenerator.hh"
 #include "LaunchPolicy.hh"
+#include "LehmerGcd.hh"
+#include "LimbArithmetic.hh"
+#include "MillerRabinRounds.hh"
+#include "MontgomeryContext.hh"
 #include "Mt19937RandomGenerator.hh"
+#include "NttMultiplication.hh"
+#include "Parallel.hh"
 #include "Typedefs.hh"
+#include "WordMontgomeryContext.hh"
+#include "Workspace.hh"
 
 namespace cml {
 
@@ -23,36 +41,245 @@ struct IsPowerOf2 {
     static constexpr bool value  = (number != 0) && ((number & (number - 1)) == 0);
 };
 
+/**
+ * \brief Residue context for an odd modulus of type T
+ *
+ * Montgomery reduction replaces the division of the double-width product, in single words for built-in
+ * unsigned types. Other built-in types keep the hardware division.
+ */
+template <typename T>
+using OddModulusContext =
+    std::conditional_t<IsSingleLimb<T>::value,
+                       WordMontgomeryContext<T>,
+                       std::conditional_t<std::is_integral<T>::value, DivisionContext<T>, MontgomeryContext<T>>>;
+
+/**
+ * \brief Reduction strategy of a residue context
+ */
+enum class Reduction { Division, Barrett, Montgomery };
+
+// Crossovers measured by the reduction benchmark: division stays the cheapest for fewer multiplications
+// or while multiplications times modulus limbs stay below divisionMaxLimbProducts
+constexpr std::size_t barrettMinMultiplications        = 4;
+constexpr std::size_t divisionMaxLimbProducts          = 32;
+constexpr std::size_t montgomeryMinMultiplications     = 16;
+constexpr std::size_t wordMontgomeryMinMultiplications = 4;
+
+/**
+ * \brief Picks the cheapest reduction for a modulus reused for about \a multiplications products
+ *
+ * Division needs no setup, Barrett one division for its reciprocal and Montgomery a few more plus the
+ * conversion of every number, while per product Montgomery is the cheapest and division the dearest.
+ * Built-in types choose between the hardware division and single-word Montgomery reduction.
+ */
+template <typename T>
+Reduction chooseReduction(const T& modulus, std::size_t multiplications)
+{
+    if constexpr (std::is_integral<T>::value) {
+        if (IsSingleLimb<T>::value && modulus > 2 && modulus % 2 == 1 &&
+            multiplications >= wordMontgomeryMinMultiplications)
+            return Reduction::Montgomery;
+        return Reduction::Division;
+    }
+    else {
+        if (modulus < 3 || multiplications < barrettMinMultiplications ||
+            multiplications * limbLength(modulus) < divisionMaxLimbProducts)
+            return Reduction::Division;
+        if (modulus % 2 == 1 && multiplications >= montgomeryMinMultiplications)
+            return Reduction::Montgomery;
+        return Reduction::Barrett;
+    }
+}
+
+/**
+ * \brief Calls function with the residue context chooseReduction picks for the modulus
+ */
+template <typename T, class Function>
+decltype(auto) withReductionContext(const T& modulus, std::size_t multiplications, Function&& function)
+{
+    if constexpr (IsSingleLimb<T>::value) {
+        if (chooseReduction(modulus, multiplications) == Reduction::Montgomery)
+            return function(WordMontgomeryContext<T>{ modulus });
+        return function(DivisionContext<T>{ modulus });
+    }
+    else if constexpr (std::is_integral<T>::value) {
+        return function(DivisionContext<T>{ modulus });
+    }
+    else {
+        switch (chooseReduction(modulus, multiplications)) {
+            case Reduction::Montgomery:
+                return function(MontgomeryContext<T>{ modulus });
+            case Reduction::Barrett:
+                return function(BarrettContext<T>{ modulus });
+            default:
+                return function(DivisionContext<T>{ modulus });
+        }
+    }
+}
+
 template <typename T>
 T modexp(T base, T exp, T modulus)
 {
-    using namespace boost::multiprecision;
+    if (modulus == 1)
+        return 0;
+
+    return withReductionContext(modulus, bitLength(exp), [&base, &exp](const auto& context) {
+        return context.modexp(base, exp);
+    });
+}
+
+/**
+ * \brief base^exp mod modulus into an existing number
+ * \param workspace Buffers kept between calls, with them the steady state doesn't allocate
+ */
+template <typename T, typename ExpType>
+void modexp(T& result, const T& base, const ExpType& exp, const T& modulus, Workspace<T>& workspace)
+{
+    workspace.modexp(result, base, exp, modulus);
+}
+
+/**
+ * \brief a * b mod modulus into an existing number
+ * \param workspace Buffers kept between calls, with them the steady state doesn't allocate
+ */
+template <typename T>
+void modmul(T& result, const T& a, const T& b, const T& modulus, Workspace<T>& workspace)
+{
+    workspace.modmul(result, a, b, modulus);
+}
+
+/**
+ * \brief Product of bases[i]^exps[i] modulo modulus
+ *
+ * Interleaves the sliding windows of all exponents, so the product takes as many squarings as the
+ * longest exponent alone instead of one chain of squarings per base.
+ */
+template <typename T, typename ExpType = T>
+T multiExp(const std::vector<T>& bases, const std::vector<ExpType>& exps, T modulus)
+{
+    if (bases.size() != exps.size())
+        throw std::domain_error{ "cml::multiExp(...): Bases and exponents count mismatch" };
 
     if (modulus == 1)
         return 0;
 
-    auto newBase = static_cast<typename ExtendedContainer<T>::Type>(base % modulus);
-    auto result  = static_cast<typename ExtendedContainer<T>::Type>(1);
+    auto multiply = [&bases, &exps](const auto& context) {
+        std::vector<typename std::decay_t<decltype(context)>::Residue> residues{};
+        residues.reserve(bases.size());
+        for (auto&& base : bases) {
+            residues.push_back(context.toResidue(base));
+        }
+        return context.fromResidue(detail::multiPower(context, residues, exps));
+    };
+
+    Uint32 expBits = 0;
+    for (auto&& exp : exps) {
+        expBits = std::max(expBits, bitLength(exp));
+    }
+
+    return withReductionContext(modulus, expBits, multiply);
+}
+
+/**
+ * \brief a^x * b^y modulo modulus with shared squarings
+ */
+template <typename T>
+T multiExp(T a, T x, T b, T y, T modulus)
+{
+    return multiExp<T, T>({ a, b }, { x, y }, modulus);
+}
+
+namespace detail {
 
-    while (exp > 0) {
-        if ((exp % 2) == 1)
-            result = (result * newBase) % modulus;
-        exp     = exp >> 1;
-        newBase = (newBase * newBase) % modulus;
+// Euclid's algorithm on T itself, for built-in types and negative multiprecision numbers
+template <typename T>
+constexpr T euclidGcd(T a, T b)
+{
+    while (b != 0) {
+        T c = a % b;
+        a   = b;
+        b   = c;
+    }
+    return a;
+}
+
+// Extended Euclid on T itself, unsigned types get the coefficients modulo 2^bits
+template <typename T>
+T euclidGcdex(T a, T b, T& x, T& y)
+{
+    // Remainders start from (b, a), the same quotients as the recursive definition
+    T previous = b, current = a;
+    T previousX = 0, currentX = 1;
+    T previousY = 1, currentY = 0;
+
+    while (current != 0) {
+        const T q = previous / current;
+
+        T next    = previous - q * current;
+        previous  = current;
+        current   = next;
+        next      = previousX - q * currentX;
+        previousX = currentX;
+        currentX  = next;
+        next      = previousY - q * currentY;
+        previousY = currentY;
+        currentY  = next;
     }
 
-    return static_cast<T>(result);
+    x = previousX;
+    y = previousY;
+    return previous;
 }
 
+// Signed value as T, wrapped modulo 2^bits for unsigned T
+template <typename T>
+T fromUnbounded(const UnboundedInt& value)
+{
+    if (value < 0 && !std::numeric_limits<T>::is_signed)
+        return T{ 0 } - static_cast<T>(UnboundedInt{ -value });
+    return static_cast<T>(value);
+}
+
+// value modulo a positive modulus in [0, modulus), also for negative values of signed types
+template <typename T>
+T reduceModulo(const T& value, const T& modulus)
+{
+    T result = value % modulus;
+    if constexpr (std::numeric_limits<T>::is_signed) {
+        if (result < 0)
+            result += modulus;
+    }
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * \brief Greatest common divisor
+ * \return gcd(a, b), \a a if \a b is 0
+ *
+ * Iterative: Euclid for built-in types, also in constant expressions, Lehmer's algorithm for non-negative
+ * multiprecision numbers.
+ */
 template <typename T>
-T gcd(T a, T b)
+constexpr T gcd(T a, T b)
 {
-    T c = a % b;
-    if (c == 0)
-        return b;
-    return gcd(b, c);
+    if constexpr (std::is_integral<T>::value) {
+        return detail::euclidGcd(a, b);
+    }
+    else {
+        if (a < 0 || b < 0)
+            return detail::euclidGcd(a, b);
+        return static_cast<T>(detail::lehmerGcd(UnboundedInt{ a }, UnboundedInt{ b }));
+    }
 }
 
+/**
+ * \brief Miller-Rabin test with k random bases
+ * \return false if \a number is composite, true if it is prime or a strong pseudoprime to all the bases
+ * \param policy Sync and Async run the rounds one after another. Parallel spreads them over threads with a
+ * random stream each, and the first witness stops the rest, for numbers of thousands of bits
+ */
 template <typename T, class RandomGenerator>
 bool millerRabinTest(T number, Uint32 k, RandomGenerator &randomGenerator, LaunchPolicy policy = LaunchPolicy::Sync)
 {
@@ -60,54 +287,115 @@ bool millerRabinTest(T number, Uint32 k, RandomGenerator &randomGenerator, Launc
                   "Invalid template argument for cml:millerRabinTest(...): RandomGenerator interface is "
                   "not suitable");
 
-    // If n == 2 or n == 3 - number is prime
-    if (number == 2 || number == 3)
-        return true;
-
-    // If n < 2 or n even
-    if (number < 2 || number % 2 == 0)
-        return false;
-
-    // Imagine n - 1 as (2^b)*m, where m is odd
-    T m      = number - 1;
-    Uint32 b = 0;
-
-    while (m % 2 == 0) {
-        m /= 2;
-        ++b;
+    // Fixed bases decide built-in widths exactly, no rounds and no generator needed
+    if constexpr (IsSingleLimb<T>::value) {
+        return isPrime64(static_cast<Uint64>(number));
     }
+    else {
+        // If n == 2 or n == 3 - number is prime
+        if (number == 2 || number == 3)
+            return true;
+
+        // If n < 2 or n even
+        if (number < 2 || number % 2 == 0)
+            return false;
 
-    for (Uint32 i = 0; i < k; i++) {
-        // Random integer [2, number - 2]
+        // Imagine n - 1 as (2^b)*m, where m is odd
+        T m      = number - 1;
+        Uint32 b = 0;
 
-        T a = static_cast<T>(randomGenerator(2, number - 2));
+        while (m % 2 == 0) {
+            m /= 2;
+            ++b;
+        }
 
-        // x = a^m mod number
-        T x = modexp<T>(a, m, number);
+        // One context per candidate, all rounds stay in its residue form. Most candidates are composite and
+        // rejected by the first round, so the context is chosen for a single exponentiation
+        auto rounds = [&](const auto& context) {
+            using Residue = typename std::decay_t<decltype(context)>::Residue;
+
+            const auto& one        = context.one();
+            const Residue minusOne = context.toResidue(number - 1);
+
+            // True if a proves the number composite
+            const auto isWitness = [&](const T& a, Residue& x, Residue& square) {
+                // x = a^m mod number
+                x = context.power(context.toResidue(a), m);
+
+                // If x == 1 or x == n - 1, then go to next iteration
+                if (x == one || x == minusOne)
+                    return false;
+
+                for (Uint32 r = 1; r < b; r++) {
+                    // x = x^2 mod number
+                    context.multiply(square, x, x);
+                    std::swap(x, square);
+
+                    // If x == 1, then return "complex number"
+                    if (x == one)
+                        return true;
+
+                    // If x == n - 1, then go next iteration outside loop
+                    if (x == minusOne)
+                        return false;
+                }
+
+                return true;
+            };
+
+            if (policy == LaunchPolicy::Parallel && k > 1) {
+                // Every worker draws its bases from its own stream, seeded here, so the rounds share neither the
+                // generator nor its lock. The first witness stops the rounds not yet started
+                struct Worker {
+                    std::mt19937_64 engine;
+                    Residue x;
+                    Residue square;
+                };
+
+                return detail::parallelAll(
+                    k,
+                    [&](std::size_t) {
+                        const Uint64 seed = detail::workerSeed(randomGenerator, policy);
+                        return Worker{ std::mt19937_64{ seed }, Residue{}, Residue{} };
+                    },
+                    [&](Worker& worker, std::size_t) {
+                        boost::random::uniform_int_distribution<T> distribution{ 2, number - 2 };
+                        return !isWitness(distribution(worker.engine), worker.x, worker.square);
+                    });
+            }
 
-        // If x == 1 or x == n - 1, then go to next iteration
-        if (x == 1 || x == number - 1)
-            continue;
+            Residue x{};
+            Residue square{};
 
-        for (Uint32 r = 1; r < b; r++) {
-            // x = x^2 mod number
-            x = modexp<T>(x, 2ull, number);
+            for (Uint32 i = 0; i < k; i++) {
+                // Random integer [2, number - 2]
 
-            // If x == 1, then return "complex number"
-            if (x == 1)
-                return false;
+                T a = static_cast<T>(randomGenerator(2, number - 2));
+                if (isWitness(a, x, square))
+                    return false;
+            }
 
-            // If x == n - 1, then go next iteration outside loop
-            if (x == number - 1)
-                break;
-        }
+            // Return "probably prime"
+            return true;
+        };
 
-        if (x != number - 1)
-            return false;
+        return withReductionContext(number, bitLength(number), rounds);
     }
+}
 
-    // Return "probably prime"
-    return true;
+/**
+ * \brief Pocklington's criterion for a safe prime candidate
+ * \param safePrime 2 * q + 1 for a prime q
+ * \return true if and only if \a safePrime is prime, a proof once q is
+ *
+ * The prime factor q of p - 1 = 2 * q exceeds sqrt(p) - 1, so p is prime as soon as a single base a has
+ * a^(p - 1) = 1 mod p and gcd(a^2 - 1, p) = 1. For a = 2 the gcd is gcd(3, p), and every prime p but 3
+ * passes: one exponentiation decides, where Miller-Rabin takes one per round and still leaves an error.
+ */
+template <typename T>
+bool pocklingtonSafePrimeTest(const T& safePrime)
+{
+    return safePrime % 3 != 0 && modexp<T>(2, safePrime - 1, safePrime) == 1;
 }
 
 // Utility function to store prime factors of a number
@@ -146,25 +434,18 @@ std::set<T> primitiveFactors(T number)
 /**
  * \brief Function to find smallest primitive root of n
  * \tparam T Return type
+ * \tparam RoundPolicy Miller-Rabin round count for the bit length of \a n, BitLengthRounds or ErrorBoundRounds
  * \param randomGenerator
  * \param policy Launch policy - need block random generator by mutex or not
  * \param n Modulus
  * \return Primitive root if has, 0 if \a n is primitive or if no roots
  */
-template <typename T, class RandomGenerator>
+template <typename T, class RandomGenerator, class RoundPolicy = BitLengthRounds>
 T primitiveRootModulo(T n, RandomGenerator &randomGenerator, LaunchPolicy policy = LaunchPolicy::Sync)
 {
-    T testable                = n;
-    std::uint32_t repeatCount = 0;
-
-    while (testable != 0) {
-        testable = testable >> 1;
-        ++repeatCount;
-    }
-
     // Check if n is prime or not
 
-    if (!millerRabinTest<T, RandomGenerator>(n, repeatCount, randomGenerator, policy))
+    if (!millerRabinTest<T, RandomGenerator>(n, RoundPolicy::rounds(bitLength(n)), randomGenerator, policy))
         return 0;
 
     T one = 1;
@@ -199,32 +480,219 @@ T primitiveRootModulo(T n, RandomGenerator &randomGenerator, LaunchPolicy policy
     return 0;
 }
 
-// Euclid extended algorithm
+/**
+ * \brief Euclid extended algorithm
+ * \param x, y Receive the coefficients of a * x + b * y = gcd(a, b), modulo 2^bits for unsigned types
+ * \return gcd(a, b)
+ *
+ * Iterative, Lehmer's algorithm for non-negative multiprecision numbers.
+ */
 template <typename T>
-T gcdex(T a, T b, T &x, T &y)
+T gcdex(T a, T b, T& x, T& y)
 {
-    if (a == 0) {
-        x = 0;
-        y = 1;
-        return b;
+    if constexpr (std::is_integral<T>::value) {
+        return detail::euclidGcdex(a, b, x, y);
+    }
+    else {
+        if (a < 0 || b < 0)
+            return detail::euclidGcdex(a, b, x, y);
+
+        if (a == 0) {
+            x = 0;
+            y = 1;
+            return b;
+        }
+
+        const UnboundedInt wideA{ a }, wideB{ b };
+        UnboundedInt coefficient{};
+        const UnboundedInt d = detail::lehmerGcd(wideA, wideB, &coefficient);
+
+        x = detail::fromUnbounded<T>(coefficient);
+        y = b == 0 ? T{ 0 } : detail::fromUnbounded<T>(UnboundedInt{ (d - wideA * coefficient) / wideB });
+        return static_cast<T>(d);
     }
-    T x1, y1;
-    T d = gcdex<T>(b % a, a, x1, y1);
-    x   = y1 - (b / a) * x1;
-    y   = x1;
-    return d;
 }
 
-// Inverse modulo
+/**
+ * \brief Inverse modulo
+ * \param m Positive modulus
+ * \return x in [0, m) with a * x = 1 (mod m)
+ * \throw std::domain_error If \a m isn't positive or \a a and \a m aren't coprime
+ */
 template <typename T>
 T invmod(T a, T m)
 {
-    T x, y;
-    gcdex(a, m, x, y);
-    x = (x % m + m) % m;
-    return x;
+    if (m <= 0)
+        throw std::domain_error{ "cml::invmod(a, m): Modulus must be positive" };
+
+    if constexpr (std::is_integral<T>::value) {
+        using Unsigned = std::make_unsigned_t<T>;
+
+        const T number = detail::reduceModulo(a, m);
+
+        // Euclid from (m, a) on the magnitudes of the cofactors of a, s[i] is positive for odd i
+        Unsigned previous         = static_cast<Unsigned>(m);
+        Unsigned current          = static_cast<Unsigned>(number);
+        Unsigned previousCofactor = 0, currentCofactor = 1;
+        bool odd                  = true;
+
+        while (current != 0) {
+            const Unsigned q = previous / current;
+
+            Unsigned next    = previous - q * current;
+            previous         = current;
+            current          = next;
+            next             = previousCofactor + q * currentCofactor;
+            previousCofactor = currentCofactor;
+            currentCofactor  = next;
+            odd              = !odd;
+        }
+
+        if (previous != 1)
+            throw std::domain_error{ "cml::invmod(a, m): Number isn't invertible modulo m" };
+
+        // previousCofactor is s[i - 1], positive when i, the index of current, is even
+        if (!odd || previousCofactor == 0)
+            return static_cast<T>(previousCofactor);
+        return static_cast<T>(static_cast<Unsigned>(m) - previousCofactor);
+    }
+    else {
+        const UnboundedInt modulus{ m };
+        UnboundedInt number = UnboundedInt{ a } % modulus;
+        if (number < 0)
+            number += modulus;
+
+        UnboundedInt coefficient{};
+        if (detail::lehmerGcd(number, modulus, &coefficient) != 1)
+            throw std::domain_error{ "cml::invmod(a, m): Number isn't invertible modulo m" };
+
+        if (coefficient < 0)
+            coefficient += modulus;
+        return static_cast<T>(coefficient);
+    }
 }
 
+/**
+ * \brief Inverses of a batch of numbers modulo the same modulus
+ * \tparam T Type of the numbers and of the modulus
+ */
+template <typename T>
+struct InverseBatch {
+    std::vector<T> inverses{}; // inverses[i] * values[i] = 1 (mod modulus), 0 for non-invertible values
+    std::vector<std::size_t> nonInvertible{}; // Ascending indices of the values sharing a factor with modulus
+};
+
+/**
+ * \brief Inverses of every value modulo one modulus by Montgomery's trick
+ * \param values Numbers to invert, may be negative or not reduced
+ * \param modulus Positive modulus
+ * \throw std::domain_error If \a modulus isn't positive
+ *
+ * One inversion of the product of all values plus 3(n - 1) multiplications in a residue context instead of
+ * n inversions. A value sharing a factor with the modulus doesn't fail the batch: zeros are left out of the
+ * product right away, other ones are found by their gcd with the modulus if the product isn't invertible.
+ */
+template <typename T>
+InverseBatch<T> invmodBatch(const std::vector<T>& values, const T& modulus)
+{
+    if (modulus <= 0)
+        throw std::domain_error{ "cml::invmodBatch(values, modulus): Modulus must be positive" };
+
+    InverseBatch<T> batch{};
+    batch.inverses.assign(values.size(), T{ 0 });
+
+    // Everything is invertible modulo 1, every inverse is 0
+    if (modulus == 1)
+        return batch;
+
+    std::vector<T> numbers{};
+    std::vector<std::size_t> invertible{};
+    numbers.reserve(values.size());
+    invertible.reserve(values.size());
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        numbers.push_back(detail::reduceModulo(values[i], modulus));
+        if (numbers.back() == 0)
+            batch.nonInvertible.push_back(i);
+        else
+            invertible.push_back(i);
+    }
+
+    // false if the product of the numbers at invertible isn't invertible
+    auto invert = [&](const auto& context) {
+        using Residue = typename std::decay_t<decltype(context)>::Residue;
+
+        const std::size_t count = invertible.size();
+        if (count == 0)
+            return true;
+
+        // prefixes[k] = numbers[invertible[0]] * ... * numbers[invertible[k]]
+        std::vector<Residue> residues(count), prefixes(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            residues[k] = context.toResidue(numbers[invertible[k]]);
+        }
+        prefixes[0] = residues[0];
+        for (std::size_t k = 1; k < count; ++k) {
+            context.multiply(prefixes[k], prefixes[k - 1], residues[k]);
+        }
+
+        const T product = context.fromResidue(prefixes[count - 1]);
+        if (cml::gcd(product, modulus) != 1)
+            return false;
+
+        // inverse runs through the inverses of the prefixes, from the whole product down to the first number
+        Residue inverse = context.toResidue(invmod(product, modulus));
+        Residue element{}, buffer{};
+        for (std::size_t k = count - 1; k > 0; --k) {
+            context.multiply(element, inverse, prefixes[k - 1]);
+            batch.inverses[invertible[k]] = context.fromResidue(element);
+
+            context.multiply(buffer, inverse, residues[k]);
+            std::swap(inverse, buffer);
+        }
+        batch.inverses[invertible[0]] = context.fromResidue(inverse);
+
+        return true;
+    };
+
+    // Each number is converted to and from the residue form once. For multiprecision moduli that outweighs
+    // the cheaper Montgomery products, Barrett's residues are plain numbers
+    const std::size_t multiplications = 3 * values.size();
+
+    auto invertAll = [&] {
+        if constexpr (std::is_integral<T>::value) {
+            return withReductionContext(modulus, multiplications, invert);
+        }
+        else {
+            if (chooseReduction(modulus, multiplications) == Reduction::Division)
+                return invert(DivisionContext<T>{ modulus });
+            return invert(BarrettContext<T>{ modulus });
+        }
+    };
+
+    if (invertAll())
+        return batch;
+
+    // A composite modulus shares a factor with some of the numbers, leave them out as well
+    std::vector<std::size_t> coprime{};
+    for (std::size_t i : invertible) {
+        if (cml::gcd(numbers[i], modulus) == 1)
+            coprime.push_back(i);
+        else
+            batch.nonInvertible.push_back(i);
+    }
+    invertible = std::move(coprime);
+    std::sort(batch.nonInvertible.begin(), batch.nonInvertible.end());
+
+    invertAll();
+    return batch;
+}
+
+/**
+ * \brief Exact power number^power
+ *
+ * Products of operands of nttMinLimbs limbs and more go through mulLarge.
+ */
 template <typename T>
 UnboundedInt binpow(T number, T power)
 {
@@ -232,9 +700,12 @@ UnboundedInt binpow(T number, T power)
     UnboundedInt a   = number;
     while (power != 0) {
         if ((power & 1) == 1)
-            res *= a;
-        a *= a;
+            res = mulLarge(res, a);
         power >>= 1;
+
+        // The square after the top bit would be the largest product and is never used
+        if (power != 0)
+            a = mulLarge(a, a);
     }
     return res;
 }
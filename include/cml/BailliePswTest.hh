@@ -0,0 +1,232 @@
+#pragma once
+
+#include <type_traits>
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/integer.hpp>
+
+#include "Algorithms.hh"
+#include "ConstexprArithmetic.hh"
+#include "LimbArithmetic.hh"
+#include "ResidueArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Jacobi symbol (a / n)
+ * \param a Non-negative number
+ * \param n Odd positive number
+ * \return -1, 0 or 1
+ */
+template <typename T>
+int jacobiSymbol(T a, T n)
+{
+    int result = 1;
+    a %= n;
+
+    while (a != 0) {
+        // (2 / n) is -1 exactly for n = 3, 5 mod 8
+        while (a % 2 == 0) {
+            a /= 2;
+            const auto residue = static_cast<Uint32>(n % 8);
+            if (residue == 3 || residue == 5)
+                result = -result;
+        }
+
+        // Quadratic reciprocity flips the sign when both are 3 mod 4
+        std::swap(a, n);
+        if (a % 4 == 3 && n % 4 == 3)
+            result = -result;
+        a %= n;
+    }
+
+    return n == 1 ? result : 0;
+}
+
+namespace detail {
+
+template <typename T>
+bool isPerfectSquare(const T& number)
+{
+    // Squares are 0, 1, 4 or 9 modulo 16, that rejects three of four numbers without a root
+    const auto low = static_cast<Uint32>(number % 16);
+    if (low != 0 && low != 1 && low != 4 && low != 9)
+        return false;
+
+    T root{};
+    if constexpr (std::is_integral<T>::value) {
+        // Newton's method from above, never overflows
+        root = number;
+        T next = root / 2 + (root % 2);
+        while (next < root) {
+            root = next;
+            next = (root + number / root) / 2;
+        }
+    }
+    else {
+        root = boost::multiprecision::sqrt(number);
+    }
+    return root * root == number;
+}
+
+/**
+ * \brief Strong probable prime test to base 2 over a residue context of the tested odd number
+ */
+template <class Context>
+bool strongBaseTwoTest(const Context& context)
+{
+    using Value   = typename Context::Value;
+    using Residue = typename Context::Residue;
+
+    const Value& number = context.modulus();
+
+    Value odd    = number - 1;
+    Uint32 shift = 0;
+    while (odd % 2 == 0) {
+        odd /= 2;
+        ++shift;
+    }
+
+    const Residue minusOne = context.toResidue(number - 1);
+
+    Residue x = context.power(context.toResidue(Value{ 2 }), odd);
+    if (x == context.one() || x == minusOne)
+        return true;
+
+    Residue square{};
+    for (Uint32 i = 1; i < shift; ++i) {
+        context.multiply(square, x, x);
+        std::swap(x, square);
+        if (x == minusOne)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * \brief Strong Lucas probable prime test with P = 1 over a residue context of the tested odd number
+ * \param d Selfridge's D: the first of 5, -7, 9, -11, ... with (D / number) = -1
+ *
+ * With number + 1 = 2^s * k, k odd, a prime passes when U_k = 0 or V_(k * 2^r) = 0 for some r < s, for the
+ * Lucas sequences of x^2 - P * x + Q, Q = (1 - D) / 4.
+ */
+template <class Context>
+bool strongLucasTest(const Context& context, Int64 d)
+{
+    using Value   = typename Context::Value;
+    using Residue = typename Context::Residue;
+
+    const Value& number = context.modulus();
+    const ResidueAddition<Context> addition{ context };
+
+    // Residues of the signed parameters
+    const auto signedResidue = [&](Int64 value) {
+        const Value magnitude = static_cast<Value>(static_cast<Uint64>(value < 0 ? -value : value)) % number;
+        return context.toResidue(value < 0 && magnitude != 0 ? Value{ number - magnitude } : magnitude);
+    };
+    const Residue dResidue = signedResidue(d);
+    const Residue q        = signedResidue((1 - d) / 4);
+
+    Value k      = number + 1;
+    Uint32 shift = 0;
+    while (k % 2 == 0) {
+        k /= 2;
+        ++shift;
+    }
+
+    // From U_1 = 1, V_1 = P = 1 and Q^1 over the bits of k below the top one:
+    // U_2j = U_j * V_j, V_2j = V_j^2 - 2 * Q^j, and for a set bit
+    // U_(j+1) = (P * U_j + V_j) / 2, V_(j+1) = (D * U_j + P * V_j) / 2
+    Residue u = context.one(), v = context.one(), qPower = q;
+    Residue product{}, square{}, twice{}, sum{};
+
+    for (Uint32 bit = bitLength(k) - 1; bit-- > 0;) {
+        context.multiply(product, u, v);
+        std::swap(u, product);
+
+        context.multiply(square, v, v);
+        addition.add(twice, qPower, qPower);
+        addition.subtract(v, square, twice);
+
+        context.multiply(square, qPower, qPower);
+        std::swap(qPower, square);
+
+        if (boost::multiprecision::bit_test(k, bit)) {
+            addition.add(sum, u, v);
+            context.multiply(product, dResidue, u);
+            addition.add(product, product, v);
+            addition.halve(u, sum);
+            addition.halve(v, product);
+
+            context.multiply(square, qPower, q);
+            std::swap(qPower, square);
+        }
+    }
+
+    if (addition.isZero(u) || addition.isZero(v))
+        return true;
+
+    for (Uint32 r = 1; r < shift; ++r) {
+        context.multiply(square, v, v);
+        addition.add(twice, qPower, qPower);
+        addition.subtract(v, square, twice);
+        if (addition.isZero(v))
+            return true;
+
+        context.multiply(square, qPower, qPower);
+        std::swap(qPower, square);
+    }
+
+    return false;
+}
+
+} // namespace detail
+
+/**
+ * \brief Baillie-PSW primality test: a strong test to base 2 and a strong Lucas test
+ * \return false if \a number is composite, true if it is prime or the first known Baillie-PSW pseudoprime
+ *
+ * No pseudoprime is known, there is none below 2^64. Costs about three strong tests, independent of any
+ * random generator, where millerRabinTest takes one exponentiation per round.
+ */
+template <typename T>
+bool bailliePswTest(const T& number)
+{
+    static constexpr auto smallPrimes = sievePrimes<100>();
+
+    if (number < 2)
+        return false;
+    for (Uint32 prime : smallPrimes) {
+        if (number == prime)
+            return true;
+        if (number % prime == 0)
+            return false;
+    }
+
+    // Lucas parameters don't exist for squares: (D / number) is never -1
+    if (detail::isPerfectSquare(number))
+        return false;
+
+    // Selfridge's method A. The number is above 100, so D mod number is D or number - |D|, and a zero symbol
+    // means a common factor with |D|
+    Int64 d = 5;
+    while (true) {
+        const T magnitude = static_cast<T>(d < 0 ? -d : d);
+        const int symbol  = jacobiSymbol(d < 0 ? T{ number - magnitude } : magnitude, number);
+        if (symbol == -1)
+            break;
+        if (symbol == 0)
+            return false;
+
+        d = d < 0 ? 2 - d : -d - 2;
+    }
+
+    // One exponentiation and a Lucas chain over the bits of the number
+    return withReductionContext(number, 3 * bitLength(number), [&](const auto& context) {
+        return detail::strongBaseTwoTest(context) && detail::strongLucasTest(context, d);
+    });
+}
+
+} // namespace cml
\ No newline at end of file
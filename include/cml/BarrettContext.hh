@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "LimbArithmetic.hh"
+#include "ResidueArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Residue ring modulo any number greater than 1 with Barrett reduction
+ * \tparam ValueType Integer type of the modulus and of converted numbers
+ *
+ * Residues are plain little-endian limbs of numbers below the modulus, so conversion is a copy. Every
+ * product is reduced with the precomputed reciprocal mu = floor(2^(2 * limbBits * limbCount()) / n),
+ * which costs two more word multiplications than Montgomery reduction but only one division to set up.
+ */
+template <typename ValueType>
+class BarrettContext {
+public:
+    using Value   = ValueType;
+    using Residue = std::vector<Limb>;
+
+    explicit BarrettContext(const Value& modulus);
+
+    const Value& modulus() const;
+    std::size_t limbCount() const;
+
+    const Residue& one() const;
+    Residue toResidue(const Value& number) const;
+    Value fromResidue(const Residue& residue) const;
+
+    /**
+     * \brief result = a * b mod modulus
+     * \param result Must not alias \a a or \a b
+     */
+    void multiply(Residue& result, const Residue& a, const Residue& b) const;
+    Residue multiply(const Residue& a, const Residue& b) const;
+
+    template <typename ExpType>
+    Residue power(const Residue& base, const ExpType& exp) const;
+
+    template <typename ExpType>
+    Value modexp(const Value& base, const ExpType& exp) const;
+
+private:
+    // Reduces the 2 * limbCount() limbs of product into limbCount() limbs of result
+    void reduce(Limb* result, const Limb* product, Limb* scratch) const;
+
+    Value m_modulus{};
+    std::vector<Limb> m_modulusLimbs{};
+    std::vector<Limb> m_reciprocal{}; // mu, limbCount() + 1 limbs
+    Residue m_one{};
+};
+
+template <typename ValueType>
+BarrettContext<ValueType>::BarrettContext(const Value& modulus) : m_modulus(modulus)
+{
+    if (modulus < 2)
+        throw std::domain_error{ "cml::BarrettContext::BarrettContext(modulus): Modulus must be greater than 1" };
+
+    const std::size_t count = limbLength(modulus);
+    m_modulusLimbs.resize(count);
+    detail::exportLimbs(modulus, m_modulusLimbs.data(), count);
+
+    UnboundedInt wideModulus{};
+    detail::importLimbs(wideModulus, m_modulusLimbs.data(), count);
+
+    // mu only overflows its limbs for modulus 2^(limbBits * (count - 1)), the clamped value just costs
+    // one more final subtraction there
+    const UnboundedInt limit = (UnboundedInt{ 1 } << (limbBits * (count + 1))) - 1;
+    UnboundedInt reciprocal  = (UnboundedInt{ 1 } << (2 * limbBits * count)) / wideModulus;
+    if (reciprocal > limit)
+        reciprocal = limit;
+
+    m_reciprocal.resize(count + 1);
+    detail::exportLimbs(reciprocal, m_reciprocal.data(), count + 1);
+
+    m_one.assign(count, Limb{ 0 });
+    m_one[0] = 1;
+}
+
+template <typename ValueType>
+const typename BarrettContext<ValueType>::Value& BarrettContext<ValueType>::modulus() const
+{
+    return m_modulus;
+}
+
+template <typename ValueType>
+std::size_t BarrettContext<ValueType>::limbCount() const
+{
+    return m_modulusLimbs.size();
+}
+
+template <typename ValueType>
+const typename BarrettContext<ValueType>::Residue& BarrettContext<ValueType>::one() const
+{
+    return m_one;
+}
+
+template <typename ValueType>
+typename BarrettContext<ValueType>::Residue BarrettContext<ValueType>::toResidue(const Value& number) const
+{
+    Residue result(limbCount());
+    if (number < m_modulus)
+        detail::exportLimbs(number, result.data(), result.size());
+    else
+        detail::exportLimbs(static_cast<Value>(number % m_modulus), result.data(), result.size());
+    return result;
+}
+
+template <typename ValueType>
+typename BarrettContext<ValueType>::Value BarrettContext<ValueType>::fromResidue(const Residue& residue) const
+{
+    Value result{};
+    detail::importLimbs(result, residue.data(), residue.size());
+    return result;
+}
+
+template <typename ValueType>
+void BarrettContext<ValueType>::multiply(Residue& result, const Residue& a, const Residue& b) const
+{
+    const std::size_t count = limbCount();
+
+    // Product, quotient estimate and remainder, grows once per thread
+    thread_local std::vector<Limb> scratch{};
+    scratch.resize(std::max(scratch.size(), 5 * count + 3));
+
+    detail::multiplyLimbs(scratch.data(), a.data(), count, b.data(), count);
+
+    result.resize(count);
+    reduce(result.data(), scratch.data(), scratch.data() + 2 * count);
+}
+
+template <typename ValueType>
+typename BarrettContext<ValueType>::Residue BarrettContext<ValueType>::multiply(const Residue& a,
+                                                                               const Residue& b) const
+{
+    Residue result(limbCount());
+    multiply(result, a, b);
+    return result;
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename BarrettContext<ValueType>::Residue BarrettContext<ValueType>::power(const Residue& base,
+                                                                            const ExpType& exp) const
+{
+    return detail::power(*this, base, exp);
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename BarrettContext<ValueType>::Value BarrettContext<ValueType>::modexp(const Value& base,
+                                                                           const ExpType& exp) const
+{
+    return fromResidue(power(toResidue(base), exp));
+}
+
+template <typename ValueType>
+void BarrettContext<ValueType>::reduce(Limb* result, const Limb* product, Limb* scratch) const
+{
+    const std::size_t count = limbCount();
+    const Limb* modulus     = m_modulusLimbs.data();
+
+    // quotient = floor(floor(product / b^(count - 1)) * mu / b^(count + 1)) is at most 3 below the exact one,
+    // partial products below limb count - 1 can't reach the kept limbs by more than one carry and are skipped
+    const Limb* shifted = product + count - 1;
+    Limb* wide          = scratch;
+    std::fill(wide, wide + 2 * count + 2, Limb{ 0 });
+    for (std::size_t i = 0; i <= count; ++i) {
+        const DoubleLimb multiplier = m_reciprocal[i];
+        Limb carry                  = 0;
+        for (std::size_t j = i + 1 < count ? count - 1 - i : 0; j <= count; ++j) {
+            const DoubleLimb sum = shifted[j] * multiplier + wide[i + j] + carry;
+            wide[i + j]          = static_cast<Limb>(sum);
+            carry                = static_cast<Limb>(sum >> limbBits);
+        }
+        wide[i + count + 1] = carry;
+    }
+    const Limb* quotient = wide + count + 1;
+
+    // remainder = (product - quotient * modulus) mod b^(count + 1), only the low count + 1 limbs are needed
+    Limb* remainder = wide + 2 * count + 2;
+    std::fill(remainder, remainder + count + 1, Limb{ 0 });
+    for (std::size_t i = 0; i <= count; ++i) {
+        const DoubleLimb multiplier = quotient[i];
+        Limb carry                  = 0;
+        for (std::size_t j = 0; j < count && i + j <= count; ++j) {
+            const DoubleLimb sum = modulus[j] * multiplier + remainder[i + j] + carry;
+            remainder[i + j]     = static_cast<Limb>(sum);
+            carry                = static_cast<Limb>(sum >> limbBits);
+        }
+        if (i == 0)
+            remainder[count] = carry;
+    }
+    detail::subtractLimbs(remainder, product, remainder, count + 1);
+
+    while (remainder[count] != 0 || detail::compareLimbs(remainder, modulus, count) >= 0) {
+        remainder[count] -= detail::subtractLimbs(remainder, remainder, modulus, count);
+    }
+
+    std::copy(remainder, remainder + count, result);
+}
+
+} // namespace cml
\ No newline at end of file
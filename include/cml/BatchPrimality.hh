@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "DeterministicPrimality.hh"
+#include "LimbArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+namespace detail {
+
+// Candidates of one batch step, the lanes of a vector register
+constexpr std::size_t batchLanes = 4;
+
+// Montgomery constants of an odd candidate above 2^32 without small factors, R = 2^64
+struct BatchCandidate {
+    Uint64 number;
+    Uint64 inverse; // number^(-1) mod 2^64
+    Uint64 one; // R mod number
+    Uint64 radixSquared; // R^2 mod number
+    Uint64 odd; // number - 1 = 2^shift * odd
+    Uint32 shift;
+    std::size_t index; // Position in the input
+};
+
+inline BatchCandidate makeBatchCandidate(Uint64 number, std::size_t index)
+{
+    BatchCandidate candidate{ number, number, 0, 0, number - 1, 0, index };
+
+    for (Uint32 bits = 3; bits < 64; bits *= 2) {
+        candidate.inverse *= Uint64{ 2 } - number * candidate.inverse;
+    }
+
+    candidate.one          = (Uint64{ 0 } - number) % number;
+    candidate.radixSquared = static_cast<Uint64>(static_cast<DoubleLimb>(candidate.one) * candidate.one % number);
+
+    while (candidate.odd % 2 == 0) {
+        candidate.odd /= 2;
+        ++candidate.shift;
+    }
+    return candidate;
+}
+
+// Same product as WordMontgomeryContext::multiply
+inline Uint64 batchMultiply(Uint64 a, Uint64 b, Uint64 number, Uint64 inverse)
+{
+    const DoubleLimb product = static_cast<DoubleLimb>(a) * b;
+    const Uint64 q           = static_cast<Uint64>(product) * inverse;
+    const Uint64 productHigh = static_cast<Uint64>(product >> 64);
+    const Uint64 reducedHigh = static_cast<Uint64>((static_cast<DoubleLimb>(q) * number) >> 64);
+    return productHigh - reducedHigh + (productHigh < reducedHigh ? number : Uint64{ 0 });
+}
+
+/**
+ * \brief Strong tests of batchLanes candidates to one base, in lockstep
+ * \return Bit i set if candidate i passes
+ *
+ * The lanes are independent chains of products, interleaved they keep the multiplier busy where a single
+ * test waits for every product. The exponents differ, so every step squares all lanes and takes the
+ * multiplication by the base where the lane's bit is set.
+ */
+inline Uint32 strongBatch(const BatchCandidate* group, Uint64 base)
+{
+    Uint64 x[batchLanes], residue[batchLanes], minusOne[batchLanes];
+    Uint32 topBit = 0, maxShift = 0;
+    for (std::size_t i = 0; i < batchLanes; ++i) {
+        const BatchCandidate& lane = group[i];
+        residue[i]                 = batchMultiply(base, lane.radixSquared, lane.number, lane.inverse);
+        minusOne[i]                = lane.number - lane.one;
+        x[i]                       = lane.one;
+        topBit                     = std::max(topBit, bitLength(lane.odd));
+        maxShift                   = std::max(maxShift, lane.shift);
+    }
+
+    for (Uint32 bit = topBit; bit-- > 0;) {
+        for (std::size_t i = 0; i < batchLanes; ++i) {
+            const BatchCandidate& lane = group[i];
+            const Uint64 square        = batchMultiply(x[i], x[i], lane.number, lane.inverse);
+            const Uint64 product       = batchMultiply(square, residue[i], lane.number, lane.inverse);
+            x[i]                       = ((lane.odd >> bit) & 1) != 0 ? product : square;
+        }
+    }
+
+    Uint32 passed = 0;
+    for (std::size_t i = 0; i < batchLanes; ++i) {
+        passed |= (x[i] == group[i].one || x[i] == minusOne[i]) ? 1u << i : 0;
+    }
+    for (Uint32 round = 1; round < maxShift; ++round) {
+        for (std::size_t i = 0; i < batchLanes; ++i) {
+            const BatchCandidate& lane = group[i];
+            x[i]                       = batchMultiply(x[i], x[i], lane.number, lane.inverse);
+            passed |= (round < lane.shift && x[i] == minusOne[i]) ? 1u << i : 0;
+        }
+    }
+    return passed;
+}
+
+} // namespace detail
+
+/**
+ * \brief Exact primality of many 64-bit numbers, as isPrime64 of each
+ * \param numbers \a count numbers to test
+ * \param results \a count flags, set to true for the primes
+ *
+ * Candidates run through the strong tests four at a time in lockstep, as interleaved chains of word
+ * products. The gain over separate isPrime64 calls grows with the share of primes, which take all seven
+ * bases.
+ */
+inline void millerRabinBatch(const Uint64* numbers, bool* results, std::size_t count)
+{
+    using detail::BatchCandidate;
+    using detail::batchLanes;
+
+    // Words up to 2^32 and numbers with small factors cost a division or a table lookup, the rest waits for
+    // the lanes
+    std::vector<BatchCandidate> candidates{};
+    for (std::size_t i = 0; i < count; ++i) {
+        const Uint64 number = numbers[i];
+        results[i]          = false;
+        if (number <= 0xFFFFFFFF)
+            results[i] = isPrime32(static_cast<Uint32>(number));
+        else if (number % 2 != 0 && !detail::hasSmallOddFactor(number))
+            candidates.push_back(detail::makeBatchCandidate(number, i));
+    }
+
+    // Base by base, keeping only the candidates that pass: most composites fail the first base, and the
+    // later bases run on full groups of primes
+    for (Uint64 base : detail::sinclairBases) {
+        if (candidates.empty())
+            break;
+
+        // A short last group repeats its first candidate
+        const std::size_t total = candidates.size();
+        while (candidates.size() % batchLanes != 0) {
+            candidates.push_back(candidates[total - total % batchLanes]);
+        }
+
+        std::size_t kept = 0;
+        for (std::size_t group = 0; group < total; group += batchLanes) {
+            const Uint32 passed = detail::strongBatch(candidates.data() + group, base);
+            for (std::size_t i = 0; i < batchLanes && group + i < total; ++i) {
+                if (((passed >> i) & 1) != 0)
+                    candidates[kept++] = candidates[group + i];
+            }
+        }
+        candidates.resize(kept);
+    }
+
+    for (const BatchCandidate& candidate : candidates) {
+        results[candidate.index] = true;
+    }
+}
+
+inline std::vector<bool> millerRabinBatch(const std::vector<Uint64>& numbers)
+{
+    // std::vector<bool> has no contiguous storage
+    const std::unique_ptr<bool[]> flags = std::make_unique<bool[]>(numbers.size());
+    millerRabinBatch(numbers.data(), flags.get(), numbers.size());
+    return std::vector<bool>(flags.get(), flags.get() + numbers.size());
+}
+
+} // namespace cml
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Algorithms.hh"
+#include "ProductTree.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+namespace detail {
+
+// The first count primes, by a sieve over the bound of Rosser's theorem
+inline std::vector<Uint32> firstPrimes(std::size_t count)
+{
+    const double n   = static_cast<double>(std::max<std::size_t>(count, 6));
+    const auto limit = static_cast<std::size_t>(n * (std::log(n) + std::log(std::log(n)))) + 1;
+
+    std::vector<bool> composite(limit + 1, false);
+    std::vector<Uint32> primes{};
+    primes.reserve(count);
+    for (std::size_t i = 2; i <= limit && primes.size() < count; ++i) {
+        if (composite[i])
+            continue;
+        primes.push_back(static_cast<Uint32>(i));
+        for (std::size_t j = i * i; j <= limit; j += i) {
+            composite[j] = true;
+        }
+    }
+    return primes;
+}
+
+} // namespace detail
+
+/**
+ * \brief Trial division of many candidates at once, against the product of the first primes
+ *
+ * Bernstein's batch method: the remainder tree of the candidates' product tree gives the product of the
+ * primes modulo every candidate, and a candidate has a factor among them exactly when that remainder shares
+ * a factor with it. The tree work is quasi-linear in the total length of candidates and primes, so the
+ * prime count can go far beyond what one-by-one trial division affords: the cost per candidate is one
+ * gcd plus a logarithmic share of the tree instead of one division per prime.
+ */
+class BatchTrialDivision {
+public:
+    /**
+     * \param primeCount Number of primes to divide by, from 2 upwards
+     */
+    explicit BatchTrialDivision(std::size_t primeCount);
+
+    const std::vector<Uint32>& primes() const;
+    const UnboundedInt& primeProduct() const;
+
+    /**
+     * \brief Candidates that may be prime
+     * \return Flag per candidate: true if it is one of the primes or has none of them as a factor
+     */
+    template <typename T>
+    std::vector<bool> survivors(const std::vector<T>& candidates) const;
+
+private:
+    std::vector<Uint32> m_primes{};
+    UnboundedInt m_primeProduct{};
+};
+
+inline BatchTrialDivision::BatchTrialDivision(std::size_t primeCount) : m_primes(detail::firstPrimes(primeCount))
+{
+    if (primeCount == 0)
+        throw std::domain_error{ "cml::BatchTrialDivision::BatchTrialDivision(primeCount): No primes" };
+
+    m_primeProduct = ProductTree{ std::vector<UnboundedInt>(m_primes.begin(), m_primes.end()) }.root();
+}
+
+inline const std::vector<Uint32>& BatchTrialDivision::primes() const
+{
+    return m_primes;
+}
+
+inline const UnboundedInt& BatchTrialDivision::primeProduct() const
+{
+    return m_primeProduct;
+}
+
+template <typename T>
+std::vector<bool> BatchTrialDivision::survivors(const std::vector<T>& candidates) const
+{
+    std::vector<bool> result(candidates.size(), false);
+
+    const Uint32 productBits = bitLength(m_primeProduct);
+
+    // Tree levels above the length of the prime product would only pass it down unchanged, so the
+    // candidates go in batches of about that length, each with its own tree
+    std::vector<UnboundedInt> leaves{};
+    std::vector<std::size_t> positions{};
+    std::size_t batchBits = 0;
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        // 0 and 1 would break the tree and are no primes anyway
+        if (candidates[i] >= 2) {
+            leaves.emplace_back(candidates[i]);
+            positions.push_back(i);
+            batchBits += bitLength(leaves.back());
+        }
+        if (leaves.empty() || (batchBits < productBits && i + 1 < candidates.size()))
+            continue;
+
+        const ProductTree tree{ std::move(leaves) };
+        const std::vector<UnboundedInt> remainders = tree.remainders(m_primeProduct);
+        for (std::size_t j = 0; j < positions.size(); ++j) {
+            const UnboundedInt& candidate = tree.leaf(j);
+            if (cml::gcd(remainders[j], candidate) == 1) {
+                result[positions[j]] = true;
+            }
+            else if (candidate <= m_primes.back()) {
+                result[positions[j]] =
+                    std::binary_search(m_primes.begin(), m_primes.end(), static_cast<Uint32>(candidate));
+            }
+        }
+
+        leaves.clear();
+        positions.clear();
+        batchBits = 0;
+    }
+    return result;
+}
+
+} // namespace cml
\ No newline at end of file
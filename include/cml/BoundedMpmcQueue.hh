@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace cml {
+namespace detail {
+
+/**
+ * \brief Bounded queue for any number of producers and consumers, without locks
+ *
+ * Dmitry Vyukov's array queue: every cell carries a sequence number that tells producers and consumers
+ * whose turn it is, so each side claims a cell with one compare-and-swap on its own position and the two
+ * sides only meet in the cell. Push and pop take constant time and fail at once when full or empty.
+ */
+template <typename T>
+class BoundedMpmcQueue {
+public:
+    /**
+     * \param capacity Rounded up to a power of 2
+     */
+    explicit BoundedMpmcQueue(std::size_t capacity);
+
+    // False if the queue is full, the value is left alone then
+    bool push(T& value);
+
+    // False if the queue is empty
+    bool pop(T& value);
+
+    // Exact while no push or pop runs, otherwise between the sizes before and after them
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    // Apart, so producers and consumers don't share a cache line
+    alignas(64) std::atomic<std::size_t> m_pushPosition{ 0 };
+    alignas(64) std::atomic<std::size_t> m_popPosition{ 0 };
+};
+
+template <typename T>
+BoundedMpmcQueue<T>::BoundedMpmcQueue(std::size_t capacity)
+{
+    std::size_t size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+
+    m_mask  = size - 1;
+    m_cells = std::make_unique<Cell[]>(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool BoundedMpmcQueue<T>::push(T& value)
+{
+    // A cell is free for position when its sequence equals it, a consumer has not emptied it yet when
+    // the sequence is behind
+    std::size_t position = m_pushPosition.load(std::memory_order_relaxed);
+    Cell* cell           = nullptr;
+    while (true) {
+        cell                   = &m_cells[position & m_mask];
+        const std::size_t turn = cell->sequence.load(std::memory_order_acquire);
+        const auto difference  = static_cast<std::intptr_t>(turn) - static_cast<std::intptr_t>(position);
+        if (difference == 0) {
+            if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0) {
+            return false;
+        }
+        else {
+            position = m_pushPosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool BoundedMpmcQueue<T>::pop(T& value)
+{
+    // A cell holds the value for position when its sequence is one ahead of it
+    std::size_t position = m_popPosition.load(std::memory_order_relaxed);
+    Cell* cell           = nullptr;
+    while (true) {
+        cell                   = &m_cells[position & m_mask];
+        const std::size_t turn = cell->sequence.load(std::memory_order_acquire);
+        const auto difference  = static_cast<std::intptr_t>(turn) - static_cast<std::intptr_t>(position + 1);
+        if (difference == 0) {
+            if (m_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0) {
+            return false;
+        }
+        else {
+            position = m_popPosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    value = std::move(cell->value);
+    cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+std::size_t BoundedMpmcQueue<T>::size() const
+{
+    const std::size_t popped = m_popPosition.load(std::memory_order_acquire);
+    const std::size_t pushed = m_pushPosition.load(std::memory_order_acquire);
+    return pushed > popped ? pushed - popped : 0;
+}
+
+template <typename T>
+std::size_t BoundedMpmcQueue<T>::capacity() const
+{
+    return m_mask + 1;
+}
+
+} // namespace detail
+} // namespace cml
\ No newline at end of file
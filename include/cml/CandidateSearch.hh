@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "ConstexprArithmetic.hh"
+#include "ContainerByBitness.hh"
+#include "DeterministicPrimality.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+namespace detail {
+
+// Trial divisors of the candidates, the 303 primes below 2000
+inline constexpr auto searchPrimes = sievePrimes<2000>();
+
+// Largest number of bitness bits
+template <Uint32 bitness, typename T>
+T searchMaxLimit()
+{
+    return static_cast<T>((typename ContainerByBitness<bitness + 1>::Type{ 1 } << bitness) - 1);
+}
+
+// Random odd number of exactly bitness bits
+template <Uint32 bitness, typename T, class RandomGenerator>
+T randomSearchStart(RandomGenerator& randomGenerator)
+{
+    T number = static_cast<T>(randomGenerator(2, searchMaxLimit<bitness, T>()));
+    number |= 0x1;
+    number |= T{ 0x1 } << (bitness - 1);
+    return number;
+}
+
+template <typename T>
+bool isDividedBySearchPrimes(const T& number)
+{
+    for (Uint32 prime : searchPrimes) {
+        if (number % prime == 0)
+            return true;
+    }
+    return false;
+}
+
+// Odd primes below 2^16 that sieve the windows, in fours whose product fits a word: one full-width division
+// gives the residues of four primes
+struct WindowPrimes {
+    std::vector<Uint32> primes{};
+    std::vector<Uint64> products{}; // Of primes 4 * i to 4 * i + 3
+};
+
+inline const WindowPrimes& windowPrimes()
+{
+    static const WindowPrimes windowPrimes = [] {
+        WindowPrimes result{};
+        for (Uint32 number = 3; number < smallPrimeTableLimit; number += 2) {
+            if (((smallOddPrimes[number / 128] >> (number / 2 % 64)) & 1) != 0)
+                result.primes.push_back(number);
+        }
+        result.primes.resize(result.primes.size() / 4 * 4);
+        for (std::size_t i = 0; i < result.primes.size(); i += 4) {
+            const std::vector<Uint32>& primes = result.primes;
+            result.products.push_back(Uint64{ primes[i] } * primes[i + 1] * primes[i + 2] * primes[i + 3]);
+        }
+        return result;
+    }();
+    return windowPrimes;
+}
+
+// Sieving primes for a bit length, a multiple of 4 and at least all below 2000. Each removes a share 1 / p
+// of the tests, worth its division while tests are dear, so longer numbers take more, up to the whole
+// table. For 16 bits the largest stays below 2^15, under every candidate
+constexpr std::size_t windowPrimeCount(Uint32 bitness)
+{
+    return std::min<std::size_t>(std::max<std::size_t>(8 * std::size_t{ bitness }, 304), 6540) / 4 * 4;
+}
+
+// Odd numbers per window, about 6 times the average distance between primes of the bit length
+constexpr std::size_t windowSize(Uint32 bitness)
+{
+    return std::max<std::size_t>(2 * std::size_t{ bitness }, 64);
+}
+
+// Largest j for which start + 2 * j keeps bitness bits, capped at the window
+template <Uint32 bitness, typename T>
+std::size_t windowCount(const T& start)
+{
+    const T room = static_cast<T>((searchMaxLimit<bitness, T>() - start) / 2);
+    return room < windowSize(bitness) - 1 ? static_cast<std::size_t>(room) + 1 : windowSize(bitness);
+}
+
+/**
+ * \brief Sets composite[j] for every j below count where start + 2 * j has a factor among the first
+ * primeCount sieving primes, and with \a safe also where 2 * (start + 2 * j) + 1 has
+ */
+template <typename T>
+void crossOffWindow(const T& start, std::size_t count, std::size_t primeCount, bool safe, bool* composite)
+{
+    const WindowPrimes& sieve = windowPrimes();
+
+    std::fill(composite, composite + count, false);
+    for (std::size_t i = 0; i < primeCount; i += 4) {
+        const Uint64 groupResidue = static_cast<Uint64>(start % sieve.products[i / 4]);
+        for (std::size_t k = i; k < i + 4; ++k) {
+            const Uint32 prime   = sieve.primes[k];
+            const Uint32 residue = static_cast<Uint32>(groupResidue % prime);
+            const Uint32 half    = (prime + 1) / 2; // 2^-1 mod prime
+
+            // start + 2 * j = 0 mod prime for j = -residue / 2
+            for (std::size_t j = (prime - residue) % prime * half % prime; j < count; j += prime) {
+                composite[j] = true;
+            }
+            if (!safe)
+                continue;
+
+            // 2 * (start + 2 * j) + 1 = 0 mod prime for j = (-1 / 2 - residue) / 2
+            for (std::size_t j = (2 * prime - half - residue) % prime * half % prime; j < count; j += prime) {
+                composite[j] = true;
+            }
+        }
+    }
+}
+
+// Search of SieveSearch and DoubleSieveSearch, windows from random starts until accept takes a survivor
+template <Uint32 bitness, typename T, class RandomGenerator, class Accept>
+T windowSearch(RandomGenerator& randomGenerator, Accept& accept, bool safe)
+{
+    std::array<bool, windowSize(bitness)> composite{};
+    while (true) {
+        const T start           = randomSearchStart<bitness, T>(randomGenerator);
+        const std::size_t count = windowCount<bitness, T>(start);
+
+        crossOffWindow(start, count, windowPrimeCount(bitness), safe, composite.data());
+        for (std::size_t j = 0; j < count; ++j) {
+            if (composite[j])
+                continue;
+
+            const T candidate = static_cast<T>(start + 2 * static_cast<T>(j));
+            if (accept(candidate))
+                return candidate;
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * \brief Search policy of MilRabPrimeGenerator: a fresh random number for every candidate
+ *
+ * A search policy provides static search<bitness, T>(randomGenerator, accept), the first odd candidate of
+ * exactly bitness bits without a factor below 2000 that accept(candidate) takes. Here every candidate is
+ * uniform and independent, and costs 303 full-width divisions before it reaches the test.
+ */
+struct RandomSearch {
+    template <Uint32 bitness, typename T, class RandomGenerator, class Accept>
+    static T search(RandomGenerator& randomGenerator, Accept&& accept)
+    {
+        while (true) {
+            const T candidate = detail::randomSearchStart<bitness, T>(randomGenerator);
+            if (!detail::isDividedBySearchPrimes(candidate) && accept(candidate))
+                return candidate;
+        }
+    }
+};
+
+/**
+ * \brief Search policy of MilRabPrimeGenerator: odd numbers upwards from a random start, sieved in a window
+ *
+ * The residues of the start modulo the sieving primes are taken once, a division per four primes, then
+ * every prime crosses off its multiples among the next window odd numbers with word arithmetic. Sieving
+ * costs so little that it goes up to 2^16 for long numbers: 10 percent of the odd numbers reach the test,
+ * where 15 percent pass the 303 trial divisions of RandomSearch. The window spans several prime gaps of the
+ * bit length; if it runs out, or past bitness bits, the search starts over.
+ *
+ * A prime after a long gap is found more often than one after a short gap, the usual price of incremental
+ * search, which leaves the primes with far more entropy than any use of them needs.
+ */
+struct SieveSearch {
+    template <Uint32 bitness, typename T, class RandomGenerator, class Accept>
+    static T search(RandomGenerator& randomGenerator, Accept&& accept)
+    {
+        return detail::windowSearch<bitness, T>(randomGenerator, accept, false);
+    }
+};
+
+/**
+ * \brief Search policy for safe primes 2 * q + 1: the windows of SieveSearch, crossing off q where q or
+ * 2 * q + 1 has a small factor
+ *
+ * The candidates are q, for accept to test q and 2 * q + 1. With the sieving primes of long numbers, one odd
+ * q in 150 survives both, where one in 10 survives a sieve of q alone: 15 times fewer tests of q.
+ */
+struct DoubleSieveSearch {
+    template <Uint32 bitness, typename T, class RandomGenerator, class Accept>
+    static T search(RandomGenerator& randomGenerator, Accept&& accept)
+    {
+        return detail::windowSearch<bitness, T>(randomGenerator, accept, true);
+    }
+};
+
+} // namespace cml
\ No newline at end of file
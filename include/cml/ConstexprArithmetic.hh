@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "ExtendedContainer.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief a * b mod modulus for built-in unsigned types, usable in constant expressions
+ * \param a, b Numbers below \a modulus
+ */
+template <typename T>
+constexpr T constexprModmul(T a, T b, T modulus)
+{
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) <= sizeof(Uint64),
+                  "Invalid template argument for cml::constexprModmul: T is not a built-in unsigned type");
+
+    using Product = std::conditional_t<sizeof(T) <= sizeof(Uint32), Uint64, typename ProductContainer<Uint64>::Type>;
+    return static_cast<T>(static_cast<Product>(a) * b % modulus);
+}
+
+/**
+ * \brief base^exp mod modulus for built-in unsigned types, usable in constant expressions
+ * \param modulus Positive modulus
+ */
+template <typename T, typename ExpType>
+constexpr T constexprModexp(T base, ExpType exp, T modulus)
+{
+    T result = static_cast<T>(1 % modulus);
+    base %= modulus;
+
+    while (exp != 0) {
+        if ((exp & 1) != 0)
+            result = constexprModmul(result, base, modulus);
+        base = constexprModmul(base, base, modulus);
+        exp >>= 1;
+    }
+
+    return result;
+}
+
+namespace detail {
+
+// One strong probable prime round for an odd number = 2^shift * odd + 1 > 2
+template <typename T>
+constexpr bool strongProbablePrime(T number, T base, T odd, Uint32 shift)
+{
+    base %= number;
+    if (base == 0)
+        return true;
+
+    T x = constexprModexp(base, odd, number);
+    if (x == 1 || x == number - 1)
+        return true;
+
+    for (Uint32 i = 1; i < shift; ++i) {
+        x = constexprModmul(x, x, number);
+        if (x == number - 1)
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace detail
+
+/**
+ * \brief Miller-Rabin test with fixed bases that make it exact for built-in integer types
+ * \return true if \a number is prime
+ *
+ * Bases 2, 7, 61 cover every number below 2^32, the seven bases of Jim Sinclair every number below 2^64.
+ * Usable in constant expressions.
+ */
+template <typename T>
+constexpr bool deterministicMillerRabinTest(T number)
+{
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(Uint64),
+                  "Invalid template argument for cml::deterministicMillerRabinTest: T is not a built-in integer "
+                  "type");
+
+    using Unsigned = std::conditional_t<sizeof(T) <= sizeof(Uint32), Uint32, Uint64>;
+
+    if (number < 2)
+        return false;
+    if (number < 4)
+        return true;
+    if (number % 2 == 0)
+        return false;
+
+    const auto value = static_cast<Unsigned>(number);
+
+    Unsigned odd = value - 1;
+    Uint32 shift = 0;
+    while (odd % 2 == 0) {
+        odd /= 2;
+        ++shift;
+    }
+
+    if constexpr (sizeof(Unsigned) == sizeof(Uint32)) {
+        constexpr Uint32 bases[] = { 2, 7, 61 };
+        for (Uint32 base : bases) {
+            if (!detail::strongProbablePrime<Uint32>(value, base, odd, shift))
+                return false;
+        }
+    }
+    else {
+        constexpr Uint64 bases[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+        for (Uint64 base : bases) {
+            if (!detail::strongProbablePrime<Uint64>(value, base, odd, shift))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+namespace detail {
+
+// Sieve of Eratosthenes below limit, composite[i] is set for every composite i
+template <Uint32 limit>
+constexpr std::array<bool, limit> sieveComposites()
+{
+    std::array<bool, limit> composite{};
+    for (Uint32 i = 2; i * i < limit; ++i) {
+        if (composite[i])
+            continue;
+        for (Uint32 j = i * i; j < limit; j += i) {
+            composite[j] = true;
+        }
+    }
+    return composite;
+}
+
+template <Uint32 limit>
+constexpr std::size_t primeCount()
+{
+    const std::array<bool, limit> composite = sieveComposites<limit>();
+
+    std::size_t count = 0;
+    for (Uint32 i = 2; i < limit; ++i) {
+        if (!composite[i])
+            ++count;
+    }
+    return count;
+}
+
+} // namespace detail
+
+/**
+ * \brief Every prime below limit in ascending order, by a sieve that runs at compile time
+ * \tparam limit Sieve size
+ */
+template <Uint32 limit>
+constexpr std::array<Uint32, detail::primeCount<limit>()> sievePrimes()
+{
+    const std::array<bool, limit> composite = detail::sieveComposites<limit>();
+
+    std::array<Uint32, detail::primeCount<limit>()> primes{};
+    std::size_t count = 0;
+    for (Uint32 i = 2; i < limit; ++i) {
+        if (!composite[i])
+            primes[count++] = i;
+    }
+    return primes;
+}
+
+} // namespace cml
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+
+#include "LimbArithmetic.hh"
+#include "Typedefs.hh"
+#include "WordMontgomeryContext.hh"
+
+namespace cml {
+namespace detail {
+
+constexpr Uint32 smallPrimeTableLimit = Uint32{ 1 } << 16;
+
+// Bit i % 64 of word i / 64 is set when 2 * i + 1 is prime, for the odd numbers below smallPrimeTableLimit
+constexpr std::array<Uint64, smallPrimeTableLimit / 128> oddPrimeBits()
+{
+    std::array<bool, smallPrimeTableLimit / 2> composite{};
+    composite[0] = true; // 1
+    for (Uint32 i = 3; i * i < smallPrimeTableLimit; i += 2) {
+        if (composite[i / 2])
+            continue;
+        for (Uint32 j = i * i; j < smallPrimeTableLimit; j += 2 * i) {
+            composite[j / 2] = true;
+        }
+    }
+
+    std::array<Uint64, smallPrimeTableLimit / 128> bits{};
+    for (Uint32 i = 0; i < smallPrimeTableLimit / 2; ++i) {
+        if (!composite[i])
+            bits[i / 64] |= Uint64{ 1 } << (i % 64);
+    }
+    return bits;
+}
+
+// 4 KiB, built by the compiler
+inline constexpr std::array<Uint64, smallPrimeTableLimit / 128> smallOddPrimes = oddPrimeBits();
+
+// Jim Sinclair's bases, strong tests to all of them decide primality of every number below 2^64
+constexpr Uint64 sinclairBases[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+// Divisibility by the odd primes below 32, which catches most composites before any exponentiation
+template <typename T>
+bool hasSmallOddFactor(T number)
+{
+    for (T prime : { 3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u }) {
+        if (number % prime == 0)
+            return true;
+    }
+    return false;
+}
+
+// One strong probable prime round modulo an odd number = 2^shift * odd + 1 above 2^16, in Montgomery form
+// with R = 2^32: products fit 64 bits, so nothing needs a double-limb division
+inline bool strongHalfWordTest(Uint32 number, Uint32 inverse, Uint32 base, Uint32 odd, Uint32 shift)
+{
+    // (t + q * number) / 2^32 for q making the low half zero, the sum may carry past 64 bits
+    const auto reduce = [&](Uint64 t) {
+        const Uint32 q       = static_cast<Uint32>(t) * inverse;
+        const Uint64 reduced = (t >> 32) + ((Uint64{ q } * number) >> 32) + (static_cast<Uint32>(t) != 0 ? 1 : 0);
+        return static_cast<Uint32>(reduced >= number ? reduced - number : reduced);
+    };
+
+    const Uint32 one      = static_cast<Uint32>((Uint64{ 1 } << 32) % number);
+    const Uint32 minusOne = number - one;
+
+    const Uint32 residue = static_cast<Uint32>((Uint64{ base } << 32) % number);
+    if (residue == 0)
+        return true;
+
+    Uint32 x = residue;
+    for (Uint32 bit = bitLength(odd) - 1; bit-- > 0;) {
+        x = reduce(Uint64{ x } * x);
+        if (((odd >> bit) & 1) != 0)
+            x = reduce(Uint64{ x } * residue);
+    }
+
+    if (x == one || x == minusOne)
+        return true;
+
+    for (Uint32 i = 1; i < shift; ++i) {
+        x = reduce(Uint64{ x } * x);
+        if (x == minusOne)
+            return true;
+    }
+
+    return false;
+}
+
+// Same round modulo a 64-bit number, over its Montgomery context
+inline bool strongWordTest(const WordMontgomeryContext<Uint64>& context, Uint64 base, Uint64 odd, Uint32 shift)
+{
+    const Uint64 number = context.modulus();
+    base %= number;
+    if (base == 0)
+        return true;
+
+    const Limb one      = context.one();
+    const Limb minusOne = number - one;
+
+    // Binary powering in registers, context.power() would set up window tables on the heap
+    const Limb residue = context.toResidue(base);
+    Limb x             = residue;
+    for (Uint32 bit = bitLength(odd) - 1; bit-- > 0;) {
+        x = context.multiply(x, x);
+        if (((odd >> bit) & 1) != 0)
+            x = context.multiply(x, residue);
+    }
+
+    if (x == one || x == minusOne)
+        return true;
+
+    for (Uint32 i = 1; i < shift; ++i) {
+        x = context.multiply(x, x);
+        if (x == minusOne)
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace detail
+
+/**
+ * \brief Exact primality of a 32-bit number, without a random generator
+ *
+ * Table lookup below 2^16, strong tests to the bases 2, 7 and 61 above, which no composite below 2^32
+ * passes.
+ */
+inline bool isPrime32(Uint32 number)
+{
+    if (number < detail::smallPrimeTableLimit)
+        return number == 2 || (number % 2 == 1 && ((detail::smallOddPrimes[number / 128] >> (number / 2 % 64)) & 1));
+    if (number % 2 == 0 || detail::hasSmallOddFactor(number))
+        return false;
+
+    Uint32 odd   = number - 1;
+    Uint32 shift = 0;
+    while (odd % 2 == 0) {
+        odd /= 2;
+        ++shift;
+    }
+
+    // number^-1 mod 2^32 by Newton's iteration, each step doubles the correct low bits
+    Uint32 inverse = number;
+    for (Uint32 bits = 3; bits < 32; bits *= 2) {
+        inverse *= 2 - number * inverse;
+    }
+
+    for (Uint32 base : { 2u, 7u, 61u }) {
+        if (!detail::strongHalfWordTest(number, Uint32{ 0 } - inverse, base, odd, shift))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Exact primality of a 64-bit number, without a random generator
+ *
+ * isPrime32 below 2^32, strong tests to the seven bases of Jim Sinclair above, which no composite below
+ * 2^64 passes.
+ */
+inline bool isPrime64(Uint64 number)
+{
+    if (number <= 0xFFFFFFFF)
+        return isPrime32(static_cast<Uint32>(number));
+    if (number % 2 == 0 || detail::hasSmallOddFactor(number))
+        return false;
+
+    Uint64 odd   = number - 1;
+    Uint32 shift = 0;
+    while (odd % 2 == 0) {
+        odd /= 2;
+        ++shift;
+    }
+
+    const WordMontgomeryContext<Uint64> context{ number };
+    for (Uint64 base : detail::sinclairBases) {
+        if (!detail::strongWordTest(context, base, odd, shift))
+            return false;
+    }
+    return true;
+}
+
+} // namespace cml
\ No newline at end of file
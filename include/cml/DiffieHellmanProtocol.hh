@@ -1,9 +1,13 @@
 #pragma once
 
 #include <future>
+#include <memory>
 
+#include "Algorithms.hh"
+#include "FixedBaseExponentiator.hh"
 #include "IsPrimeGenerator.hh"
 #include "IsRandomGenerator.hh"
+#include "LaunchPolicy.hh"
 
 namespace cml {
 
@@ -13,31 +17,69 @@ namespace cml {
 
 template <typename ValueType>
 struct DiffieHellmanSecurityBase {
-    using Value = ValueType;
+    using Value         = ValueType;
+    using Exponentiator = FixedBaseExponentiator<Value>;
 
+    /**
+     * \brief p from the prime generator, g its smallest primitive root
+     * \param policy Launch policy of the prime generator and of the primality test on p
+     */
     template <class PrimeGeneratorType, class RandomGeneratorType>
-    static DiffieHellmanSecurityBase<ValueType> create(PrimeGeneratorType& primeGenerator, RandomGeneratorType& randomGenerator);
+    static DiffieHellmanSecurityBase<ValueType> create(PrimeGeneratorType& primeGenerator,
+                                                       RandomGeneratorType& randomGenerator,
+                                                       LaunchPolicy policy = LaunchPolicy::Sync);
+
+    /**
+     * \brief Builds the fixed-base table for g, copies of this security base share it
+     */
+    void precompute();
+
+    /**
+     * \brief g^exp mod p, through the precomputed table if it was built for the current g and p
+     */
+    Value generatorPower(const Value& exp) const;
 
     Value g{ 0 };
     Value p{ 0 };
+    std::shared_ptr<const Exponentiator> exponentiator{}; // optional, see precompute()
 };
 
 template <typename ValueType>
 template <class PrimeGeneratorType, class RandomGeneratorType>
 DiffieHellmanSecurityBase<ValueType> DiffieHellmanSecurityBase<ValueType>::create(PrimeGeneratorType& primeGenerator,
-                                                                                  RandomGeneratorType& randomGenerator)
+                                                                                  RandomGeneratorType& randomGenerator,
+                                                                                  LaunchPolicy policy)
 {
     static_assert(IsPrimeGenerator<PrimeGeneratorType>::value,
                   "Invalid template argument for cml::DiffieHellmanSecurityBase: PrimeGeneratorType "
                   "interface is not suitable");
 
     DiffieHellmanSecurityBase securityBase{};
-    securityBase.p = static_cast<Value>(primeGenerator());
-    securityBase.g = static_cast<Value>(primitiveRootModulo(securityBase.p, randomGenerator));
+    securityBase.p = static_cast<Value>(primeGenerator(policy));
+    securityBase.g = static_cast<Value>(primitiveRootModulo(securityBase.p, randomGenerator, policy));
 
     return securityBase;
 }
 
+template <typename ValueType>
+void DiffieHellmanSecurityBase<ValueType>::precompute()
+{
+    if (g == 0 || p == 0)
+        throw std::logic_error{ "Security base is not generated" };
+
+    exponentiator = std::make_shared<const Exponentiator>(g, p, bitLength(p));
+}
+
+template <typename ValueType>
+typename DiffieHellmanSecurityBase<ValueType>::Value
+    DiffieHellmanSecurityBase<ValueType>::generatorPower(const Value& exp) const
+{
+    if (exponentiator && exponentiator->base() == g && exponentiator->context().modulus() == p)
+        return exponentiator->modexp(exp);
+
+    return modexp(g, exp, p);
+}
+
 template <typename ValueType>
 struct DiffieHellmanPublicKey {
     using Value = ValueType;
@@ -92,6 +134,6 @@ void DiffieHellmanProtocol<ValueType, RandomGeneratorType>::generate(const Secur
         throw std::logic_error{ "Security base is not generated" };
 
     privateKey.a = static_cast<typename PrivateKey::Value>(randomGenerator());
-    publicKey.v  = modexp(securityBase.g, privateKey.a, securityBase.p);
+    publicKey.v  = securityBase.generatorPower(privateKey.a);
 }
 } // namespace cml
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "ExtendedContainer.hh"
+#include "ResidueArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Residue ring modulo a number, reduced by plain division of the double-width product
+ * \tparam ValueType Integer type of the modulus and of converted numbers
+ *
+ * Shares the interface of MontgomeryContext, so it serves even moduli and native widths where a
+ * hardware division is cheaper than Montgomery setup.
+ */
+template <typename ValueType>
+class DivisionContext {
+public:
+    using Value   = ValueType;
+    using Residue = typename ProductContainer<Value>::Type;
+
+    explicit DivisionContext(const Value& modulus);
+
+    const Value& modulus() const;
+
+    const Residue& one() const;
+    Residue toResidue(const Value& number) const;
+    Value fromResidue(const Residue& residue) const;
+
+    void multiply(Residue& result, const Residue& a, const Residue& b) const;
+    Residue multiply(const Residue& a, const Residue& b) const;
+
+    template <typename ExpType>
+    Residue power(const Residue& base, const ExpType& exp) const;
+
+    template <typename ExpType>
+    Value modexp(const Value& base, const ExpType& exp) const;
+
+private:
+    Value m_modulus{};
+    Residue m_wideModulus{};
+    Residue m_one{};
+};
+
+template <typename ValueType>
+DivisionContext<ValueType>::DivisionContext(const Value& modulus) :
+    m_modulus(modulus),
+    m_wideModulus(static_cast<Residue>(modulus)),
+    m_one(static_cast<Residue>(Residue{ 1 } % m_wideModulus))
+{}
+
+template <typename ValueType>
+const typename DivisionContext<ValueType>::Value& DivisionContext<ValueType>::modulus() const
+{
+    return m_modulus;
+}
+
+template <typename ValueType>
+const typename DivisionContext<ValueType>::Residue& DivisionContext<ValueType>::one() const
+{
+    return m_one;
+}
+
+template <typename ValueType>
+typename DivisionContext<ValueType>::Residue DivisionContext<ValueType>::toResidue(const Value& number) const
+{
+    return static_cast<Residue>(static_cast<Residue>(number) % m_wideModulus);
+}
+
+template <typename ValueType>
+typename DivisionContext<ValueType>::Value DivisionContext<ValueType>::fromResidue(const Residue& residue) const
+{
+    return static_cast<Value>(residue);
+}
+
+template <typename ValueType>
+void DivisionContext<ValueType>::multiply(Residue& result, const Residue& a, const Residue& b) const
+{
+    result = static_cast<Residue>((a * b) % m_wideModulus);
+}
+
+template <typename ValueType>
+typename DivisionContext<ValueType>::Residue DivisionContext<ValueType>::multiply(const Residue& a,
+                                                                                 const Residue& b) const
+{
+    Residue result{};
+    multiply(result, a, b);
+    return result;
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename DivisionContext<ValueType>::Residue DivisionContext<ValueType>::power(const Residue& base,
+                                                                              const ExpType& exp) const
+{
+    return detail::power(*this, base, exp);
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename DivisionContext<ValueType>::Value DivisionContext<ValueType>::modexp(const Value& base,
+                                                                             const ExpType& exp) const
+{
+    return fromResidue(power(toResidue(base), exp));
+}
+
+} // namespace cml
\ No newline at end of file
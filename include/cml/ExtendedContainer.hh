@@ -52,4 +52,26 @@ struct ExtendedContainer {
                                                                            UnboundedInt>>>>>>>>>>>>>>;
 };
 
+/**
+ * \brief Double-width type for intermediate products, never handed out to callers
+ *
+ * Same as ExtendedContainer, except that every 64-bit built-in type (unsigned long long included, which
+ * is a distinct type from Uint64 on some platforms) maps to the compiler's native 128-bit integer where
+ * it has one, so the product and its remainder stay in hardware registers.
+ */
+template <typename T>
+struct ProductContainer {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using NativeUint128 = unsigned __int128;
+    __extension__ using NativeInt128  = __int128;
+#else
+    using NativeUint128 = Uint128;
+    using NativeInt128  = Int128;
+#endif
+
+    using Type = std::conditional_t<std::is_integral<T>::value && sizeof(T) == 8,
+                                    std::conditional_t<std::is_signed<T>::value, NativeInt128, NativeUint128>,
+                                    typename ExtendedContainer<T>::Type>;
+};
+
 } // namespace cml
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/multiprecision/integer.hpp>
+
+#include "Algorithms.hh"
+#include "LimbArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Exponentiation of one fixed base modulo one fixed modulus with a precomputed Lim-Lee comb
+ * \tparam ValueType Integer type of the base and the modulus
+ * \tparam ContextType Residue context of the modulus
+ *
+ * The exponent is split into \a rows blocks of a bits, each block into \a columns pieces of b bits.
+ * The table keeps columns * 2^rows products of base^(2^(i*a + j*b)), after which base^exp costs
+ * b - 1 squarings and at most a multiplications instead of about maxExpBits squarings.
+ */
+template <typename ValueType, class ContextType = OddModulusContext<ValueType>>
+class FixedBaseExponentiator {
+public:
+    using Value   = ValueType;
+    using Context = ContextType;
+    using Residue = typename Context::Residue;
+
+    /**
+     * \brief Builds the table
+     * \param base Fixed base
+     * \param modulus Fixed modulus
+     * \param maxExpBits Longest exponent served from the table, longer ones fall back to plain exponentiation
+     * \param rows Comb rows, table has 2^rows entries per column
+     * \param columns Comb columns, each one halves the squarings at the price of another 2^rows entries
+     */
+    FixedBaseExponentiator(const Value& base,
+                           const Value& modulus,
+                           Uint32 maxExpBits,
+                           Uint32 rows    = 8,
+                           Uint32 columns = 2);
+
+    const Value& base() const;
+    const Context& context() const;
+    Uint32 maxExpBits() const;
+    std::size_t tableSize() const;
+
+    template <typename ExpType>
+    Value modexp(const ExpType& exp) const;
+
+private:
+    Value m_baseValue{};
+    Context m_context;
+    Residue m_base{};
+    Uint32 m_maxExpBits{ 0 };
+    Uint32 m_rows{ 0 };
+    Uint32 m_columns{ 0 };
+    Uint32 m_rowBits{ 0 }; // a
+    Uint32 m_columnBits{ 0 }; // b
+    std::vector<Residue> m_table{}; // [(j << rows) + u]: product of base^(2^(i*a + j*b)) over set bits i of u
+};
+
+template <typename ValueType, class ContextType>
+FixedBaseExponentiator<ValueType, ContextType>::FixedBaseExponentiator(const Value& base,
+                                                                       const Value& modulus,
+                                                                       Uint32 maxExpBits,
+                                                                       Uint32 rows,
+                                                                       Uint32 columns) :
+    m_baseValue(base),
+    m_context(modulus),
+    m_maxExpBits(std::max<Uint32>(maxExpBits, 1)),
+    m_rows(rows),
+    m_columns(columns)
+{
+    if (rows == 0 || rows > 16 || columns == 0)
+        throw std::domain_error{ "cml::FixedBaseExponentiator::FixedBaseExponentiator(...): Invalid comb shape" };
+
+    m_base       = m_context.toResidue(base);
+    m_rowBits    = (m_maxExpBits + m_rows - 1) / m_rows;
+    m_columnBits = (m_rowBits + m_columns - 1) / m_columns;
+
+    const std::size_t entries = std::size_t{ 1 } << m_rows;
+
+    // singles[j * rows + i] = base^(2^(i*a + j*b)), collected along one chain of squarings
+    std::vector<Residue> singles(static_cast<std::size_t>(m_rows) * m_columns);
+    Residue power  = m_base;
+    Residue buffer = m_base;
+    for (Uint32 i = 0; i < m_rows; ++i) {
+        for (Uint32 bit = 0; bit < m_rowBits; ++bit) {
+            if (bit % m_columnBits == 0)
+                singles[(bit / m_columnBits) * m_rows + i] = power;
+
+            m_context.multiply(buffer, power, power);
+            std::swap(power, buffer);
+        }
+    }
+
+    m_table.resize(entries * m_columns);
+    for (Uint32 j = 0; j < m_columns && j * m_columnBits < m_rowBits; ++j) {
+        Residue* column = &m_table[j * entries];
+        column[0]       = m_context.one();
+
+        for (std::size_t u = 1; u < entries; ++u) {
+            const std::size_t lowest = u & (~u + 1);
+            const std::size_t rest   = u ^ lowest;
+            const Residue& single    = singles[j * m_rows + bitLength(lowest) - 1];
+
+            if (rest == 0)
+                column[u] = single;
+            else
+                m_context.multiply(column[u], column[rest], single);
+        }
+    }
+}
+
+template <typename ValueType, class ContextType>
+const typename FixedBaseExponentiator<ValueType, ContextType>::Value&
+    FixedBaseExponentiator<ValueType, ContextType>::base() const
+{
+    return m_baseValue;
+}
+
+template <typename ValueType, class ContextType>
+const typename FixedBaseExponentiator<ValueType, ContextType>::Context&
+    FixedBaseExponentiator<ValueType, ContextType>::context() const
+{
+    return m_context;
+}
+
+template <typename ValueType, class ContextType>
+Uint32 FixedBaseExponentiator<ValueType, ContextType>::maxExpBits() const
+{
+    return m_maxExpBits;
+}
+
+template <typename ValueType, class ContextType>
+std::size_t FixedBaseExponentiator<ValueType, ContextType>::tableSize() const
+{
+    return m_table.size();
+}
+
+template <typename ValueType, class ContextType>
+template <typename ExpType>
+typename FixedBaseExponentiator<ValueType, ContextType>::Value
+    FixedBaseExponentiator<ValueType, ContextType>::modexp(const ExpType& exp) const
+{
+    const Uint32 expBits = bitLength(exp);
+    if (expBits > m_maxExpBits)
+        return m_context.fromResidue(m_context.power(m_base, exp));
+
+    Residue result = m_context.one();
+    Residue buffer = result;
+    bool started   = false;
+
+    for (Uint32 k = m_columnBits; k-- > 0;) {
+        if (started) {
+            m_context.multiply(buffer, result, result);
+            std::swap(result, buffer);
+        }
+
+        for (Uint32 j = m_columns; j-- > 0;) {
+            const Uint32 offset = j * m_columnBits + k;
+            if (offset >= m_rowBits)
+                continue;
+
+            std::size_t u = 0;
+            for (Uint32 i = 0; i < m_rows; ++i) {
+                const Uint32 bit = i * m_rowBits + offset;
+                if (bit < expBits && boost::multiprecision::bit_test(exp, bit))
+                    u |= std::size_t{ 1 } << i;
+            }
+
+            if (u == 0)
+                continue;
+
+            const Residue& entry = m_table[(static_cast<std::size_t>(j) << m_rows) + u];
+            if (started) {
+                m_context.multiply(buffer, result, entry);
+                std::swap(result, buffer);
+            }
+            else {
+                result  = entry;
+                started = true;
+            }
+        }
+    }
+
+    return m_context.fromResidue(result);
+}
+
+} // namespace cml
\ No newline at end of file
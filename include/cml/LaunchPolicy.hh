@@ -2,9 +2,17 @@
 
 namespace cml {
 
+/**
+ * \brief How a call may use threads
+ *
+ * Sync: the caller's thread only, shared objects aren't locked. Async: the caller's thread only, shared
+ * objects such as generators are locked, several threads may call at once. Parallel: as Async, and the
+ * call itself may spread independent work over threads.
+ */
 enum class LaunchPolicy {
     Sync,
     Async,
+    Parallel,
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "LimbArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+namespace detail {
+
+// Bits of the leading digit Lehmer's quotients are computed from. Leaves two spare bits, so the digit plus a
+// cofactor never overflows Int64
+constexpr Uint32 lehmerDigitBits = 62;
+
+/**
+ * \brief Cofactors of the Euclid steps determined by the leading digits of two remainders
+ *
+ * After steps quotient steps the remainders (a, b) become (A * a + B * b, C * a + D * b). Every row holds
+ * one non-negative and one non-positive entry, which of them depends on the parity of steps.
+ */
+struct LehmerMatrix {
+    Int64 a      = 1;
+    Int64 b      = 0;
+    Int64 c      = 0;
+    Int64 d      = 1;
+    Uint32 steps = 0;
+};
+
+// Drops the leading zero limbs, zero becomes empty
+inline void trimLimbs(std::vector<Limb>& number)
+{
+    while (!number.empty() && number.back() == 0) {
+        number.pop_back();
+    }
+}
+
+// Reads trimmed limbs, importLimbs can't take an empty range
+inline void importTrimmedLimbs(UnboundedInt& number, const std::vector<Limb>& limbs)
+{
+    if (limbs.empty())
+        number = 0;
+    else
+        importLimbs(number, limbs.data(), limbs.size());
+}
+
+inline bool lessLimbs(const std::vector<Limb>& a, const std::vector<Limb>& b)
+{
+    if (a.size() != b.size())
+        return a.size() < b.size();
+    return compareLimbs(a.data(), b.data(), a.size()) < 0;
+}
+
+// limbBits bits of number starting at bit shift, missing limbs read as zeros
+inline Limb limbsAt(const std::vector<Limb>& number, std::size_t shift)
+{
+    const std::size_t index  = shift / limbBits;
+    const std::size_t offset = shift % limbBits;
+
+    const Limb low  = index < number.size() ? number[index] : 0;
+    const Limb high = index + 1 < number.size() ? number[index + 1] : 0;
+    return offset == 0 ? low : (low >> offset) | (high << (limbBits - offset));
+}
+
+/**
+ * \brief Knuth's algorithm L: Euclid on the leading digits while both quotient bounds agree
+ * \param a Remainder, not less than \a b
+ * \param b Non-zero remainder
+ */
+inline LehmerMatrix lehmerMatrix(const std::vector<Limb>& a, const std::vector<Limb>& b)
+{
+    const std::size_t aBits = (a.size() - 1) * limbBits + bitLength(a.back());
+    const std::size_t shift = aBits > lehmerDigitBits ? aBits - lehmerDigitBits : 0;
+
+    Int64 aDigit = static_cast<Int64>(limbsAt(a, shift));
+    Int64 bDigit = static_cast<Int64>(limbsAt(b, shift));
+
+    LehmerMatrix matrix{};
+    // Both divisors positive, otherwise the range of the true quotient is unbounded
+    while (bDigit + matrix.c > 0 && bDigit + matrix.d > 0) {
+        // Quotients of the digits rounded towards both ends of the true quotient's range
+        const Int64 q = (aDigit + matrix.a) / (bDigit + matrix.c);
+        if (q != (aDigit + matrix.b) / (bDigit + matrix.d))
+            break;
+
+        const Int64 c = matrix.a - q * matrix.c;
+        const Int64 d = matrix.b - q * matrix.d;
+        const Int64 r = aDigit - q * bDigit;
+
+        matrix.a = matrix.c;
+        matrix.b = matrix.d;
+        matrix.c = c;
+        matrix.d = d;
+        aDigit   = bDigit;
+        bDigit   = r;
+        ++matrix.steps;
+    }
+
+    return matrix;
+}
+
+// result = |x * a + y * b| for x and y of opposite signs, result must not alias a or b
+inline void combineLimbs(std::vector<Limb>& result,
+                         const std::vector<Limb>& a,
+                         Int64 x,
+                         const std::vector<Limb>& b,
+                         Int64 y)
+{
+    // Positive product first, the difference is known to be non-negative
+    const bool swapped                = x < 0 || y > 0;
+    const std::vector<Limb>& positive = swapped ? b : a;
+    const std::vector<Limb>& negative = swapped ? a : b;
+    const DoubleLimb add              = static_cast<Limb>(swapped ? y : x);
+    const DoubleLimb subtract         = static_cast<Limb>(swapped ? -x : -y);
+
+    const std::size_t count = std::max(a.size(), b.size());
+    result.resize(count);
+
+    Limb addCarry = 0, subtractCarry = 0, borrow = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const DoubleLimb lhs = (i < positive.size() ? positive[i] : 0) * add + addCarry;
+        const DoubleLimb rhs = (i < negative.size() ? negative[i] : 0) * subtract + subtractCarry;
+        addCarry             = static_cast<Limb>(lhs >> limbBits);
+        subtractCarry        = static_cast<Limb>(rhs >> limbBits);
+
+        const Limb lhsLow = static_cast<Limb>(lhs);
+        const Limb rhsLow = static_cast<Limb>(rhs);
+        result[i]         = lhsLow - rhsLow - borrow;
+        borrow            = (lhsLow < rhsLow || (lhsLow == rhsLow && borrow != 0)) ? 1 : 0;
+    }
+
+    trimLimbs(result);
+}
+
+// result = x * a + y * b for non-negative x and y, result must not alias a or b
+inline void addCombineLimbs(std::vector<Limb>& result,
+                            const std::vector<Limb>& a,
+                            Limb x,
+                            const std::vector<Limb>& b,
+                            Limb y)
+{
+    const std::size_t count = std::max(a.size(), b.size());
+    result.resize(count + 1);
+
+    Limb carry = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const DoubleLimb first  = static_cast<DoubleLimb>(i < a.size() ? a[i] : 0) * x + carry;
+        const DoubleLimb second = static_cast<DoubleLimb>(i < b.size() ? b[i] : 0) * y + static_cast<Limb>(first);
+        result[i]               = static_cast<Limb>(second);
+        carry                   = static_cast<Limb>(first >> limbBits) + static_cast<Limb>(second >> limbBits);
+    }
+    result[count] = carry;
+
+    trimLimbs(result);
+}
+
+/**
+ * \brief Greatest common divisor of non-negative numbers by Lehmer's algorithm
+ * \param coefficient If not null, receives x with a * x = gcd (mod b), the one extended Euclid returns
+ *
+ * One pass over the limbs replaces up to ~30 full-precision divisions: the quotients are taken from the
+ * leading 62 bits, and the remainders and the cofactor of \a a are updated once per batch. A division is
+ * left only for the quotients the leading bits can't determine.
+ */
+inline UnboundedInt lehmerGcd(const UnboundedInt& a, const UnboundedInt& b, UnboundedInt* coefficient = nullptr)
+{
+    using Number = std::vector<Limb>;
+
+    // Euclid runs on the remainders previous >= current, starting from (b, a), so the cofactor of a is the
+    // second one: s[0] = 0 and s[1] = 1. Only the magnitudes are kept, s[i] is positive for odd i
+    Number previous(limbLength(b)), current(limbLength(a));
+    exportLimbs(b, previous.data(), previous.size());
+    exportLimbs(a, current.data(), current.size());
+    trimLimbs(previous);
+    trimLimbs(current);
+
+    Number previousCofactor{}, currentCofactor{ 1 };
+    std::size_t index = 1;
+
+    Number remainder{}, nextRemainder{}, cofactor{}, nextCofactor{};
+    UnboundedInt dividend{}, divisor{}, quotient{}, rest{}, product{};
+
+    while (!current.empty()) {
+        const LehmerMatrix matrix = lessLimbs(previous, current) ? LehmerMatrix{} : lehmerMatrix(previous, current);
+
+        if (matrix.steps != 0) {
+            combineLimbs(remainder, previous, matrix.a, current, matrix.b);
+            combineLimbs(nextRemainder, previous, matrix.c, current, matrix.d);
+            std::swap(previous, remainder);
+            std::swap(current, nextRemainder);
+
+            // The cofactors alternate in sign like the matrix entries, so their magnitudes just add up
+            if (coefficient != nullptr) {
+                const auto magnitude = [](Int64 value) { return static_cast<Limb>(value < 0 ? -value : value); };
+                const auto& s = previousCofactor;
+                const auto& t = currentCofactor;
+                addCombineLimbs(cofactor, s, magnitude(matrix.a), t, magnitude(matrix.b));
+                addCombineLimbs(nextCofactor, s, magnitude(matrix.c), t, magnitude(matrix.d));
+                std::swap(previousCofactor, cofactor);
+                std::swap(currentCofactor, nextCofactor);
+            }
+
+            index += matrix.steps;
+            continue;
+        }
+
+        // One full division step
+        if (previous.size() == 1 && current.size() == 1) {
+            const Limb q = previous[0] / current[0];
+            remainder.assign(1, previous[0] - q * current[0]);
+            trimLimbs(remainder);
+
+            if (coefficient != nullptr)
+                addCombineLimbs(cofactor, previousCofactor, 1, currentCofactor, q);
+        }
+        else {
+            importTrimmedLimbs(dividend, previous);
+            importTrimmedLimbs(divisor, current);
+            boost::multiprecision::divide_qr(dividend, divisor, quotient, rest);
+
+            remainder.resize(limbLength(rest));
+            exportLimbs(rest, remainder.data(), remainder.size());
+            trimLimbs(remainder);
+
+            if (coefficient != nullptr) {
+                importTrimmedLimbs(product, currentCofactor);
+                product *= quotient;
+                importTrimmedLimbs(dividend, previousCofactor);
+                product += dividend;
+
+                cofactor.resize(limbLength(product));
+                exportLimbs(product, cofactor.data(), cofactor.size());
+                trimLimbs(cofactor);
+            }
+        }
+
+        std::swap(previous, current);
+        std::swap(current, remainder);
+        if (coefficient != nullptr) {
+            std::swap(previousCofactor, currentCofactor);
+            std::swap(currentCofactor, cofactor);
+        }
+        ++index;
+    }
+
+    // previous is the gcd, s[index - 1] its cofactor
+    if (coefficient != nullptr) {
+        importTrimmedLimbs(*coefficient, previousCofactor);
+        if (index % 2 == 1)
+            *coefficient = -*coefficient;
+    }
+
+    UnboundedInt result{};
+    importTrimmedLimbs(result, previous);
+    return result;
+}
+
+} // namespace detail
+} // namespace cml
\ No newline at end of file
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/integer.hpp>
+
+#include "Typedefs.hh"
+
+namespace cml {
+
+constexpr Uint32 limbBits = std::numeric_limits<Limb>::digits;
+
+/**
+ * \brief Built-in unsigned type whose values fit a single limb
+ */
+template <typename T>
+struct IsSingleLimb {
+    static constexpr bool value = std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) <= sizeof(Limb);
+};
+
+/**
+ * \brief Number of significant bits
+ * \param number Non-negative number
+ * \return 0 if \a number is 0, otherwise index of the most significant bit plus one
+ */
+template <typename T>
+Uint32 bitLength(const T& number)
+{
+    if (number == 0)
+        return 0;
+    return static_cast<Uint32>(boost::multiprecision::msb(number)) + 1;
+}
+
+/**
+ * \brief Number of limbs needed to store the number, at least one
+ */
+template <typename T>
+std::size_t limbLength(const T& number)
+{
+    return std::max<std::size_t>((bitLength(number) + limbBits - 1) / limbBits, 1);
+}
+
+namespace detail {
+
+// Writes number into count little-endian limbs and zeroes the rest. Number must fit into count limbs
+template <typename T>
+void exportLimbs(const T& number, Limb* limbs, std::size_t count)
+{
+    std::fill(limbs, limbs + count, Limb{ 0 });
+
+    if constexpr (std::is_integral<T>::value) {
+        auto value = static_cast<std::make_unsigned_t<T>>(number);
+        if constexpr (sizeof(value) <= sizeof(Limb)) {
+            limbs[0] = static_cast<Limb>(value);
+        }
+        else {
+            for (std::size_t i = 0; i < count && value != 0; ++i) {
+                limbs[i] = static_cast<Limb>(value);
+                value >>= limbBits;
+            }
+        }
+    }
+    else {
+        boost::multiprecision::export_bits(number, limbs, limbBits, false);
+    }
+}
+
+// Reads count little-endian limbs into number
+template <typename T>
+void importLimbs(T& number, const Limb* limbs, std::size_t count)
+{
+    if constexpr (std::is_integral<T>::value) {
+        if constexpr (sizeof(T) <= sizeof(Limb)) {
+            number = static_cast<T>(limbs[0]);
+        }
+        else {
+            std::make_unsigned_t<T> value = 0;
+            for (std::size_t i = std::min(count, sizeof(T) / sizeof(Limb)); i-- > 0;) {
+                value = static_cast<std::make_unsigned_t<T>>((value << limbBits) | limbs[i]);
+            }
+            number = static_cast<T>(value);
+        }
+    }
+    else {
+        boost::multiprecision::import_bits(number, limbs, limbs + count, limbBits, false);
+    }
+}
+
+// Returns -1, 0 or 1 as a is less than, equal to or greater than b
+inline int compareLimbs(const Limb* a, const Limb* b, std::size_t count)
+{
+    for (std::size_t i = count; i-- > 0;) {
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// result = a + b, returns the carry. result may alias a or b
+inline Limb addLimbs(Limb* result, const Limb* a, const Limb* b, std::size_t count)
+{
+    Limb carry = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Limb sum = a[i] + carry;
+        carry          = sum < carry ? 1 : 0;
+        result[i]      = sum + b[i];
+        carry += result[i] < sum ? 1 : 0;
+    }
+    return carry;
+}
+
+// result = a - b, returns the borrow. result may alias a or b
+inline Limb subtractLimbs(Limb* result, const Limb* a, const Limb* b, std::size_t count)
+{
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Limb lhs  = a[i];
+        const Limb rhs  = b[i];
+        const Limb diff = lhs - rhs - borrow;
+        borrow          = (lhs < rhs || (lhs == rhs && borrow != 0)) ? 1 : 0;
+        result[i]       = diff;
+    }
+    return borrow;
+}
+
+// result = a * b, result gets aCount + bCount limbs and must not alias a or b
+inline void multiplyLimbs(Limb* result, const Limb* a, std::size_t aCount, const Limb* b, std::size_t bCount)
+{
+    std::fill(result, result + aCount + bCount, Limb{ 0 });
+
+    for (std::size_t i = 0; i < bCount; ++i) {
+        const DoubleLimb multiplier = b[i];
+        Limb carry                  = 0;
+        for (std::size_t j = 0; j < aCount; ++j) {
+            const DoubleLimb sum = a[j] * multiplier + result[i + j] + carry;
+            result[i + j]        = static_cast<Limb>(sum);
+            carry                = static_cast<Limb>(sum >> limbBits);
+        }
+        result[i + aCount] = carry;
+    }
+}
+
+/**
+ * \brief number / divisor by Knuth's algorithm D, the remainder is left in the low divisorCount limbs
+ * \param quotient numberCount - divisorCount + 1 limbs or nullptr if only the remainder is needed
+ * \param number numberCount + 1 limbs, the top one is scratch space
+ * \param divisor divisorCount limbs, the top one non-zero, changed and restored
+ *
+ * One double-limb division per quotient limb and a single pass of multiply-subtract over the divisor,
+ * all in place.
+ */
+inline void divideLimbs(Limb* quotient, Limb* number, std::size_t numberCount, Limb* divisor, std::size_t divisorCount)
+{
+    number[numberCount] = 0;
+    if (numberCount < divisorCount)
+        return;
+
+    // Normalized divisors have the top bit set, so the estimate from the top limbs is at most two too high
+    const Uint32 shift   = limbBits - bitLength(divisor[divisorCount - 1]);
+    const auto shiftLeft = [shift](Limb* limbs, std::size_t count) {
+        if (shift == 0)
+            return;
+        for (std::size_t i = count; i-- > 1;) {
+            limbs[i] = (limbs[i] << shift) | (limbs[i - 1] >> (limbBits - shift));
+        }
+        limbs[0] <<= shift;
+    };
+    shiftLeft(divisor, divisorCount);
+    shiftLeft(number, numberCount + 1);
+
+    const Limb top    = divisor[divisorCount - 1];
+    const Limb second = divisorCount > 1 ? divisor[divisorCount - 2] : 0;
+    for (std::size_t j = numberCount - divisorCount + 1; j-- > 0;) {
+        Limb* window = number + j;
+
+        const DoubleLimb head = (static_cast<DoubleLimb>(window[divisorCount]) << limbBits) | window[divisorCount - 1];
+        DoubleLimb estimate   = head / top;
+        DoubleLimb rest       = head % top;
+        const Limb below      = divisorCount > 1 ? window[divisorCount - 2] : 0;
+        while (estimate >> limbBits != 0 || estimate * second > ((rest << limbBits) | below)) {
+            --estimate;
+            rest += top;
+            if (rest >> limbBits != 0)
+                break;
+        }
+
+        // window -= digit * divisor
+        const Limb digit = static_cast<Limb>(estimate);
+
+        Limb carry = 0, borrow = 0;
+        for (std::size_t i = 0; i < divisorCount; ++i) {
+            const DoubleLimb product = static_cast<DoubleLimb>(digit) * divisor[i] + carry;
+            carry                    = static_cast<Limb>(product >> limbBits);
+            const Limb low           = static_cast<Limb>(product);
+            const Limb value         = window[i];
+            window[i]                = value - low - borrow;
+            borrow                   = (value < low || (value == low && borrow != 0)) ? 1 : 0;
+        }
+        const Limb value     = window[divisorCount];
+        window[divisorCount] = value - carry - borrow;
+        const bool overshoot = value < carry || value - carry < borrow;
+
+        // The estimate was one too high, add the divisor back
+        if (overshoot)
+            window[divisorCount] += addLimbs(window, window, divisor, divisorCount);
+        if (quotient != nullptr)
+            quotient[j] = overshoot ? digit - 1 : digit;
+    }
+
+    const auto shiftRight = [shift](Limb* limbs, std::size_t count) {
+        if (shift == 0)
+            return;
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            limbs[i] = (limbs[i] >> shift) | (limbs[i + 1] << (limbBits - shift));
+        }
+        limbs[count - 1] >>= shift;
+    };
+    shiftRight(divisor, divisorCount);
+    shiftRight(number, divisorCount);
+}
+
+} // namespace detail
+} // namespace cml
\ No newline at end of file
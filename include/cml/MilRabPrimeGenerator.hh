@@ -1,19 +1,39 @@
 ﻿#pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Algorithms.hh"
+#include "CandidateSearch.hh"
 #include "ContainerByBitness.hh"
 #include "IsRandomGenerator.hh"
+#include "MillerRabinRounds.hh"
+#include "Mt19937RandomGenerator.hh"
+#include "Parallel.hh"
+#include "PrimalityTestPolicy.hh"
 #include "PrimeGenerator.hh"
 #include "Typedefs.hh"
 
 namespace cml {
 
+/**
+ * \brief Random primes of exactly primeBitness bits
+ * \tparam PrimalityTestType Test policy for the candidates that pass trial division, MillerRabinPolicy or
+ * BailliePswPolicy
+ * \tparam RoundPolicyType Round count of the test policy for primeBitness, BitLengthRounds or ErrorBoundRounds
+ * \tparam SearchPolicyType How candidates are drawn and trial divided, SieveSearch or RandomSearch
+ */
 template <Uint32 primeBitness,
           class RandomGeneratorType,
-          typename ResultType = typename ContainerByBitness<primeBitness>::Type>
+          typename ResultType     = typename ContainerByBitness<primeBitness>::Type,
+          class PrimalityTestType = MillerRabinPolicy,
+          class RoundPolicyType   = ErrorBoundRounds<128>,
+          class SearchPolicyType  = SieveSearch>
 class MilRabPrimeGenerator : public PrimeGenerator<ResultType> {
 public:
     static_assert(IsRandomGenerator<RandomGeneratorType>::value,
@@ -26,6 +46,9 @@ public:
 
     using Base            = PrimeGenerator<ResultType>;
     using RandomGenerator = RandomGeneratorType;
+    using PrimalityTest   = PrimalityTestType;
+    using RoundPolicy     = RoundPolicyType;
+    using SearchPolicy    = SearchPolicyType;
     using typename Base::Result;
 
     MilRabPrimeGenerator();
@@ -34,78 +57,115 @@ public:
     Result generate() override;
 
 private:
-    static constexpr std::array<Uint32, 303> smallPrimes{
-        2,    3,    5,    7,    11,   13,   17,   19,   23,   29,   31,   37,   41,   43,   47,   53,   59,   61,
-        67,   71,   73,   79,   83,   89,   97,   101,  103,  107,  109,  113,  127,  131,  137,  139,  149,  151,
-        157,  163,  167,  173,  179,  181,  191,  193,  197,  199,  211,  223,  227,  229,  233,  239,  241,  251,
-        257,  263,  269,  271,  277,  281,  283,  293,  307,  311,  313,  317,  331,  337,  347,  349,  353,  359,
-        367,  373,  379,  383,  389,  397,  401,  409,  419,  421,  431,  433,  439,  443,  449,  457,  461,  463,
-        467,  479,  487,  491,  499,  503,  509,  521,  523,  541,  547,  557,  563,  569,  571,  577,  587,  593,
-        599,  601,  607,  613,  617,  619,  631,  641,  643,  647,  653,  659,  661,  673,  677,  683,  691,  701,
-        709,  719,  727,  733,  739,  743,  751,  757,  761,  769,  773,  787,  797,  809,  811,  821,  823,  827,
-        829,  839,  853,  857,  859,  863,  877,  881,  883,  887,  907,  911,  919,  929,  937,  941,  947,  953,
-        967,  971,  977,  983,  991,  997,  1009, 1013, 1019, 1021, 1031, 1033, 1039, 1049, 1051, 1061, 1063, 1069,
-        1087, 1091, 1093, 1097, 1103, 1109, 1117, 1123, 1129, 1151, 1153, 1163, 1171, 1181, 1187, 1193, 1201, 1213,
-        1217, 1223, 1229, 1231, 1237, 1249, 1259, 1277, 1279, 1283, 1289, 1291, 1297, 1301, 1303, 1307, 1319, 1321,
-        1327, 1361, 1367, 1373, 1381, 1399, 1409, 1423, 1427, 1429, 1433, 1439, 1447, 1451, 1453, 1459, 1471, 1481,
-        1483, 1487, 1489, 1493, 1499, 1511, 1523, 1531, 1543, 1549, 1553, 1559, 1567, 1571, 1579, 1583, 1597, 1601,
-        1607, 1609, 1613, 1619, 1621, 1627, 1637, 1657, 1663, 1667, 1669, 1693, 1697, 1699, 1709, 1721, 1723, 1733,
-        1741, 1747, 1753, 1759, 1777, 1783, 1787, 1789, 1801, 1811, 1823, 1831, 1847, 1861, 1867, 1871, 1873, 1877,
-        1879, 1889, 1901, 1907, 1913, 1931, 1933, 1949, 1951, 1973, 1979, 1987, 1993, 1997, 1999
-    };
+    Result generateParallel() override;
 
     RandomGenerator m_randomGenerator{};
-
-    static bool isDividedBySmallPrimes(Result number);
 };
 
-template <Uint32 primeBitness, class RandomGeneratorType, typename ResultType>
-MilRabPrimeGenerator<primeBitness, RandomGeneratorType, ResultType>::MilRabPrimeGenerator() = default;
+template <Uint32 primeBitness,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+MilRabPrimeGenerator<primeBitness,
+                     RandomGeneratorType,
+                     ResultType,
+                     PrimalityTestType,
+                     RoundPolicyType,
+                     SearchPolicyType>::MilRabPrimeGenerator() = default;
 
-template <Uint32 primeBitness, class RandomGeneratorType, typename ResultType>
-MilRabPrimeGenerator<primeBitness, RandomGeneratorType, ResultType>::MilRabPrimeGenerator(
-    const RandomGenerator& randomGenerator) :
+template <Uint32 primeBitness,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+MilRabPrimeGenerator<primeBitness,
+                     RandomGeneratorType,
+                     ResultType,
+                     PrimalityTestType,
+                     RoundPolicyType,
+                     SearchPolicyType>::MilRabPrimeGenerator(const RandomGenerator& randomGenerator) :
     m_randomGenerator(randomGenerator)
 {}
 
-template <Uint32 primeBitness, class RandomGeneratorType, typename ResultType>
-typename MilRabPrimeGenerator<primeBitness, RandomGeneratorType, ResultType>::Result
-    MilRabPrimeGenerator<primeBitness, RandomGeneratorType, ResultType>::generate()
+template <Uint32 primeBitness,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+typename MilRabPrimeGenerator<primeBitness,
+                              RandomGeneratorType,
+                              ResultType,
+                              PrimalityTestType,
+                              RoundPolicyType,
+                              SearchPolicyType>::Result
+    MilRabPrimeGenerator<primeBitness,
+                         RandomGeneratorType,
+                         ResultType,
+                         PrimalityTestType,
+                         RoundPolicyType,
+                         SearchPolicyType>::generate()
 {
-    Result prime    = 0;
-    Result maxLimit = static_cast<Result>((typename ContainerByBitness<bitness + 1>::Type{ 1 } << bitness) - 1);
-
-    constexpr Uint32 testRepeatCount = bitness;
-
-    while (true) {
-        // clang-format off
-        prime = static_cast<Result>(m_randomGenerator(
-            2,
-            maxLimit));
-        // clang-format on
+    constexpr Uint32 testRepeatCount = RoundPolicy::rounds(bitness);
 
-        prime |= 0x1;
-        prime |= Result{ 0x1 } << (bitness - 1);
-
-        // If number is not prime then generate next number
-        if (isDividedBySmallPrimes(prime))
-            continue;
-
-        if (millerRabinTest<Result, RandomGenerator>(prime, testRepeatCount, m_randomGenerator))
-            break;
-    }
-    return prime;
+    return SearchPolicy::template search<bitness, Result>(m_randomGenerator, [this](const Result& candidate) {
+        return PrimalityTest::test(candidate, testRepeatCount, m_randomGenerator);
+    });
 }
 
-template <Uint32 primeBitness, class RandomGeneratorType, typename ResultType>
-bool MilRabPrimeGenerator<primeBitness, RandomGeneratorType, ResultType>::isDividedBySmallPrimes(Result number)
+template <Uint32 primeBitness,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+typename MilRabPrimeGenerator<primeBitness,
+                              RandomGeneratorType,
+                              ResultType,
+                              PrimalityTestType,
+                              RoundPolicyType,
+                              SearchPolicyType>::Result
+    MilRabPrimeGenerator<primeBitness,
+                         RandomGeneratorType,
+                         ResultType,
+                         PrimalityTestType,
+                         RoundPolicyType,
+                         SearchPolicyType>::generateParallel()
 {
-    for (auto&& prime : smallPrimes) {
-        if (number % prime == 0)
-            return true;
+    using WorkerRandomGenerator = detail::WorkerRandomGenerator<Result>;
+
+    constexpr Uint32 testRepeatCount = RoundPolicy::rounds(bitness);
+
+    // One search per hardware thread, each with its own stream seeded here. Only the seeds come from the
+    // shared generator, under the lock of the Async path; the searches run unlocked
+    std::vector<Uint64> seeds(detail::workerCount(std::numeric_limits<std::size_t>::max()));
+    {
+        const std::unique_lock<std::mutex> lock = this->lock();
+        for (Uint64& seed : seeds) {
+            seed = detail::workerSeed(m_randomGenerator);
+        }
     }
 
-    return false;
+    // The first prime found stops the others at their next candidate, which they then drop
+    std::atomic<bool> found{ false };
+    Result prime{};
+
+    detail::parallelAll(
+        seeds.size(),
+        [&](std::size_t worker) { return std::make_unique<WorkerRandomGenerator>(seeds[worker]); },
+        [&](std::unique_ptr<WorkerRandomGenerator>& randomGenerator, std::size_t) {
+            const Result candidate =
+                SearchPolicy::template search<bitness, Result>(*randomGenerator, [&](const Result& number) {
+                    return found || PrimalityTest::test(number, testRepeatCount, *randomGenerator);
+                });
+            if (!found.exchange(true))
+                prime = candidate;
+            return true;
+        });
+    return prime;
 }
 
 } // namespace cml
\ No newline at end of file
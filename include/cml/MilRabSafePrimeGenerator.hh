@@ -1,16 +1,82 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
 #include "Algorithms.hh"
+#include "BoundedMpmcQueue.hh"
+#include "CandidateSearch.hh"
 #include "ExtendedContainer.hh"
 #include "IsPrimeGenerator.hh"
 #include "IsRandomGenerator.hh"
+#include "LaunchPolicy.hh"
+#include "MillerRabinRounds.hh"
+#include "Mt19937RandomGenerator.hh"
+#include "Parallel.hh"
+#include "PrimalityTestPolicy.hh"
 #include "PrimeGenerator.hh"
 
 namespace cml {
 
+/**
+ * \brief Search policy of MilRabSafePrimeGenerator: q from the prime generator, 2 * q + 1 tested after
+ *
+ * The whole generation of q is lost whenever 2 * q + 1 is composite, which takes about bitness * ln 2
+ * generations per safe prime.
+ */
+struct InnerGeneratorSearch {};
+
+namespace detail {
+
+// Pipeline workers per tester. A tester spends one exponentiation on a q that a searcher found in dozens of
+// Fermat tests, so few testers keep up, and both roles take on the other's work rather than wait
+constexpr std::size_t safePrimeWorkersPerTester = 16;
+
+// Whether a prime generator states the bit length of its primes, which a direct search of q needs
+template <class PrimeGeneratorType, typename = void>
+struct HasBitness : std::false_type {};
+
+template <class PrimeGeneratorType>
+struct HasBitness<PrimeGeneratorType, std::void_t<decltype(PrimeGeneratorType::bitness)>> : std::true_type {};
+
+template <class PrimeGeneratorType>
+using DefaultSafePrimeSearch =
+    std::conditional_t<HasBitness<PrimeGeneratorType>::value, DoubleSieveSearch, InnerGeneratorSearch>;
+
+} // namespace detail
+
+/**
+ * \brief Random safe primes 2 * q + 1 for primes q of PrimeGeneratorType's bit length
+ * \tparam PrimalityTestType Test policy for q searched by SearchPolicyType, MillerRabinPolicy or BailliePswPolicy
+ * \tparam RoundPolicyType Round count of the test policy for the bit length of q
+ * \tparam SearchPolicyType InnerGeneratorSearch, or a search policy of MilRabPrimeGenerator drawing q over
+ * PrimeGeneratorType::bitness bits from the random generator. DoubleSieveSearch by default when
+ * PrimeGeneratorType states its bitness, as MilRabPrimeGenerator does, InnerGeneratorSearch otherwise
+ *
+ * Searching q directly, DoubleSieveSearch keeps only the q where neither q nor 2 * q + 1 has a small factor,
+ * and a candidate must pass base 2 Fermat tests of both before the test policy runs on q. The prime
+ * generator is left unused then.
+ *
+ * With q prime, 2 * q + 1 is decided by pocklingtonSafePrimeTest, a proof in one exponentiation.
+ *
+ * LaunchPolicy::Parallel and generatePipelined() run a two-stage pipeline on all hardware threads, each
+ * with its own random stream: searchers sieve q and stream those passing the Fermat test into a bounded
+ * queue, testers take them out for Pocklington's test of 2 * q + 1 and the test policy on q. Under
+ * InnerGeneratorSearch they draw q from the prime generator's own LaunchPolicy::Parallel search instead.
+ */
 template <class PrimeGeneratorType,
           class RandomGeneratorType,
-          typename ResultType = typename ExtendedContainer<typename PrimeGeneratorType::Result>::Type>
+          typename ResultType     = typename ExtendedContainer<typename PrimeGeneratorType::Result>::Type,
+          class PrimalityTestType = MillerRabinPolicy,
+          class RoundPolicyType   = ErrorBoundRounds<128>,
+          class SearchPolicyType  = detail::DefaultSafePrimeSearch<PrimeGeneratorType>>
 class MilRabSafePrimeGenerator : public PrimeGenerator<ResultType> {
 public:
     static_assert(IsPrimeGenerator<PrimeGeneratorType>::value,
@@ -21,9 +87,17 @@ public:
                   "Invalid template argument for cml::MilRabSafePrimeGenerator: RandomGeneratorType interface is "
                   "not suitable");
 
+    static_assert(std::is_same<SearchPolicyType, InnerGeneratorSearch>::value ||
+                      detail::HasBitness<PrimeGeneratorType>::value,
+                  "Invalid template argument for cml::MilRabSafePrimeGenerator: SearchPolicyType searches q over "
+                  "PrimeGeneratorType::bitness bits, which PrimeGeneratorType does not state");
+
     using Base            = PrimeGenerator<ResultType>;
     using PrimeGenerator  = PrimeGeneratorType;
     using RandomGenerator = RandomGeneratorType;
+    using PrimalityTest   = PrimalityTestType;
+    using RoundPolicy     = RoundPolicyType;
+    using SearchPolicy    = SearchPolicyType;
     using Result          = typename Base::Result;
 
     MilRabSafePrimeGenerator();
@@ -31,43 +105,267 @@ public:
 
     Result generate() override;
 
+    /**
+     * \brief Starts the pipelined search on threads of its own, the safe prime comes through the future
+     *
+     * Thread-safe as LaunchPolicy::Parallel. The generator must outlive the search, and like any future of
+     * std::async, the returned one waits for the search when destroyed.
+     */
+    std::future<Result> generatePipelined();
+
     PrimeGenerator primeGenerator{};
     RandomGenerator randomGenerator{};
+
+private:
+    Result generateParallel() override;
+
+    // Seeds of the random streams of the pipeline, one per hardware thread
+    std::vector<Uint64> pipelineSeeds();
+
+    // Runs the pipeline on the calling thread and one more per seed after the first, returns the safe prime
+    static Result pipeline(const std::vector<Uint64>& seeds);
 };
 
-template <class PrimeGeneratorType, class RandomGeneratorType, typename ResultType>
-MilRabSafePrimeGenerator<PrimeGeneratorType, RandomGeneratorType, ResultType>::MilRabSafePrimeGenerator() = default;
+template <class PrimeGeneratorType,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+MilRabSafePrimeGenerator<PrimeGeneratorType,
+                         RandomGeneratorType,
+                         ResultType,
+                         PrimalityTestType,
+                         RoundPolicyType,
+                         SearchPolicyType>::
+    MilRabSafePrimeGenerator() = default;
 
-template <class PrimeGeneratorType, class RandomGeneratorType, typename ResultType>
-MilRabSafePrimeGenerator<PrimeGeneratorType, RandomGeneratorType, ResultType>::MilRabSafePrimeGenerator(
-    const PrimeGenerator& primeGenerator,
-    const RandomGenerator& randomGenerator) :
+template <class PrimeGeneratorType,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+MilRabSafePrimeGenerator<PrimeGeneratorType,
+                         RandomGeneratorType,
+                         ResultType,
+                         PrimalityTestType,
+                         RoundPolicyType,
+                         SearchPolicyType>::
+    MilRabSafePrimeGenerator(const PrimeGenerator& primeGenerator, const RandomGenerator& randomGenerator) :
     primeGenerator(primeGenerator), randomGenerator(randomGenerator)
 {}
 
-template <class PrimeGeneratorType, class RandomGeneratorType, typename ResultType>
-typename MilRabSafePrimeGenerator<PrimeGeneratorType, RandomGeneratorType, ResultType>::Result
-    MilRabSafePrimeGenerator<PrimeGeneratorType, RandomGeneratorType, ResultType>::generate()
+template <class PrimeGeneratorType,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+typename MilRabSafePrimeGenerator<PrimeGeneratorType,
+                                  RandomGeneratorType,
+                                  ResultType,
+                                  PrimalityTestType,
+                                  RoundPolicyType,
+                                  SearchPolicyType>::Result
+    MilRabSafePrimeGenerator<PrimeGeneratorType,
+                             RandomGeneratorType,
+                             ResultType,
+                             PrimalityTestType,
+                             RoundPolicyType,
+                             SearchPolicyType>::generate()
 {
     using SafePrime = Result;
 
-    SafePrime safePrime{};
-    while (true) {
-        SafePrime prime = static_cast<SafePrime>(primeGenerator());
-        safePrime       = prime * 2 + 1;
+    if constexpr (std::is_same<SearchPolicy, InnerGeneratorSearch>::value) {
+        SafePrime safePrime{};
+        while (true) {
+            SafePrime prime = static_cast<SafePrime>(primeGenerator());
+            safePrime       = prime * 2 + 1;
 
-        auto testable      = prime;
-        Uint32 repeatCount = 0;
+            if (pocklingtonSafePrimeTest(safePrime))
+                break;
+        }
 
-        while (testable != 0) {
-            testable = testable >> 1;
-            ++repeatCount;
+        return safePrime;
+    }
+    else {
+        const SafePrime prime = SearchPolicy::template search<PrimeGenerator::bitness, SafePrime>(
+            randomGenerator, [this](const SafePrime& candidate) {
+                // A composite q fails the Fermat test at the cost of a single exponentiation, and for a prime q
+                // Pocklington's test is exact: the test policy only runs on q with 2 * q + 1 already settled
+                if (modexp<SafePrime>(2, candidate - 1, candidate) != 1 ||
+                    !pocklingtonSafePrimeTest(static_cast<SafePrime>(candidate * 2 + 1)))
+                    return false;
+                return PrimalityTest::test(candidate, RoundPolicy::rounds(bitLength(candidate)), randomGenerator);
+            });
+
+        return prime * 2 + 1;
+    }
+}
+
+template <class PrimeGeneratorType,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+std::future<typename MilRabSafePrimeGenerator<PrimeGeneratorType,
+                                              RandomGeneratorType,
+                                              ResultType,
+                                              PrimalityTestType,
+                                              RoundPolicyType,
+                                              SearchPolicyType>::Result>
+    MilRabSafePrimeGenerator<PrimeGeneratorType,
+                             RandomGeneratorType,
+                             ResultType,
+                             PrimalityTestType,
+                             RoundPolicyType,
+                             SearchPolicyType>::generatePipelined()
+{
+    if constexpr (std::is_same<SearchPolicy, InnerGeneratorSearch>::value)
+        return std::async(std::launch::async, [this] { return generateParallel(); });
+    else
+        return std::async(std::launch::async, &MilRabSafePrimeGenerator::pipeline, pipelineSeeds());
+}
+
+template <class PrimeGeneratorType,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+typename MilRabSafePrimeGenerator<PrimeGeneratorType,
+                                  RandomGeneratorType,
+                                  ResultType,
+                                  PrimalityTestType,
+                                  RoundPolicyType,
+                                  SearchPolicyType>::Result
+    MilRabSafePrimeGenerator<PrimeGeneratorType,
+                             RandomGeneratorType,
+                             ResultType,
+                             PrimalityTestType,
+                             RoundPolicyType,
+                             SearchPolicyType>::generateParallel()
+{
+    if constexpr (std::is_same<SearchPolicy, InnerGeneratorSearch>::value) {
+        // generate() draws from the inner generator under this generator's lock, so its parallel search does too
+        const std::unique_lock<std::mutex> lock = this->lock();
+        while (true) {
+            const Result safePrime = static_cast<Result>(primeGenerator(LaunchPolicy::Parallel)) * 2 + 1;
+            if (pocklingtonSafePrimeTest(safePrime))
+                return safePrime;
         }
+    }
+    else {
+        return pipeline(pipelineSeeds());
+    }
+}
 
-        if (millerRabinTest(safePrime, repeatCount, randomGenerator))
-            break;
+template <class PrimeGeneratorType,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+std::vector<Uint64>
+    MilRabSafePrimeGenerator<PrimeGeneratorType,
+                             RandomGeneratorType,
+                             ResultType,
+                             PrimalityTestType,
+                             RoundPolicyType,
+                             SearchPolicyType>::pipelineSeeds()
+{
+    // Drawn under the lock generate() runs under on the Async path, since it draws from the same generator
+    std::vector<Uint64> seeds(detail::workerCount(std::numeric_limits<std::size_t>::max()));
+    const std::unique_lock<std::mutex> lock = this->lock();
+    for (Uint64& seed : seeds) {
+        seed = detail::workerSeed(randomGenerator);
     }
+    return seeds;
+}
 
-    return safePrime;
+template <class PrimeGeneratorType,
+          class RandomGeneratorType,
+          typename ResultType,
+          class PrimalityTestType,
+          class RoundPolicyType,
+          class SearchPolicyType>
+typename MilRabSafePrimeGenerator<PrimeGeneratorType,
+                                  RandomGeneratorType,
+                                  ResultType,
+                                  PrimalityTestType,
+                                  RoundPolicyType,
+                                  SearchPolicyType>::Result
+    MilRabSafePrimeGenerator<PrimeGeneratorType,
+                             RandomGeneratorType,
+                             ResultType,
+                             PrimalityTestType,
+                             RoundPolicyType,
+                             SearchPolicyType>::pipeline(const std::vector<Uint64>& seeds)
+{
+    using SafePrime             = Result;
+    using WorkerRandomGenerator = detail::WorkerRandomGenerator<SafePrime>;
+
+    struct Worker {
+        std::unique_ptr<WorkerRandomGenerator> randomGenerator;
+        bool tester;
+    };
+
+    const std::size_t workers = seeds.size();
+    const std::size_t testers = std::max<std::size_t>(workers / detail::safePrimeWorkersPerTester, 1);
+
+    detail::BoundedMpmcQueue<SafePrime> survivors{ 4 * workers };
+    std::atomic<bool> found{ false };
+    SafePrime prime{};
+
+    const auto passesFermat = [](const SafePrime& candidate) {
+        return modexp<SafePrime>(2, candidate - 1, candidate) == 1;
+    };
+    const auto confirm = [](const SafePrime& candidate, WorkerRandomGenerator& randomGenerator) {
+        return pocklingtonSafePrimeTest(static_cast<SafePrime>(candidate * 2 + 1)) &&
+               PrimalityTest::test(candidate, RoundPolicy::rounds(bitLength(candidate)), randomGenerator);
+    };
+
+    detail::parallelAll(
+        workers,
+        [&](std::size_t worker) {
+            return Worker{ std::make_unique<WorkerRandomGenerator>(seeds[worker]), worker < testers };
+        },
+        [&](Worker& worker, std::size_t) {
+            while (!found) {
+                SafePrime candidate{};
+                bool confirmed = false;
+
+                if (worker.tester && survivors.pop(candidate)) {
+                    confirmed = confirm(candidate, *worker.randomGenerator);
+                }
+                else {
+                    // A searcher tests a survivor itself only when the queue is full, a tester finding the
+                    // queue empty searches and tests one survivor of its own before it looks again
+                    candidate = SearchPolicy::template search<PrimeGenerator::bitness, SafePrime>(
+                        *worker.randomGenerator, [&](const SafePrime& number) {
+                            if (found)
+                                return true;
+                            if (!passesFermat(number))
+                                return false;
+
+                            SafePrime survivor = number;
+                            if (!worker.tester && survivors.push(survivor))
+                                return false;
+                            confirmed = confirm(number, *worker.randomGenerator);
+                            return confirmed || worker.tester;
+                        });
+                }
+
+                // The first confirmed q stops the others at their next candidate
+                if (confirmed && !found.exchange(true))
+                    prime = candidate;
+            }
+            return true;
+        });
+
+    return prime * 2 + 1;
 }
+
 } // namespace cml
\ No newline at end of file
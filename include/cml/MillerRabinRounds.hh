@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Round policy: one Miller-Rabin round per bit of the tested number
+ *
+ * A round policy provides static rounds(bits), the round count for a number of that bit length. Rounds of
+ * random bases err with probability below 4^-rounds for any composite, so this one is far past any need.
+ */
+struct BitLengthRounds {
+    static constexpr Uint32 rounds(Uint32 bits)
+    {
+        return bits;
+    }
+};
+
+namespace detail {
+
+// Targets of the table columns, error probability 2^-target
+constexpr Uint32 errorBoundTargets[] = { 64, 80, 100, 112, 128 };
+
+struct ErrorBoundRow {
+    Uint32 bits;
+    Uint32 rounds[5]; // One per target
+};
+
+// Computed by the procedure of FIPS 186-4, appendix F.1, from the Damgard-Landrock-Pomerance bound, never
+// above the worst-case count target / 2
+constexpr ErrorBoundRow errorBoundRows[] = {
+    { 16, { 32, 40, 50, 56, 64 } },  { 32, { 31, 39, 49, 55, 63 } },   { 64, { 26, 34, 44, 50, 58 } },
+    { 128, { 16, 24, 34, 40, 48 } }, { 192, { 10, 15, 23, 29, 37 } },  { 256, { 7, 10, 16, 20, 27 } },
+    { 384, { 5, 7, 10, 12, 16 } },   { 512, { 4, 5, 7, 9, 12 } },      { 768, { 3, 4, 5, 6, 8 } },
+    { 1024, { 2, 3, 4, 5, 6 } },     { 1536, { 2, 2, 3, 3, 4 } },      { 2048, { 1, 2, 2, 3, 3 } },
+    { 3072, { 1, 1, 2, 2, 2 } },     { 4096, { 1, 1, 1, 2, 2 } },      { 8192, { 1, 1, 1, 1, 1 } },
+};
+
+constexpr std::size_t errorBoundColumn(Uint32 errorBits)
+{
+    for (std::size_t i = 0; i < sizeof(errorBoundTargets) / sizeof(errorBoundTargets[0]); ++i) {
+        if (errorBoundTargets[i] == errorBits)
+            return i;
+    }
+    return sizeof(errorBoundTargets) / sizeof(errorBoundTargets[0]);
+}
+
+} // namespace detail
+
+/**
+ * \brief Round policy: enough Miller-Rabin rounds for a random odd candidate of the bit length to be
+ * composite with probability at most 2^-errorBits
+ * \tparam errorBits 64, 80, 100, 112 or 128
+ *
+ * A random candidate is rarely a number most bases fail to witness, so large ones need only a few rounds:
+ * 5 for 1024 bits at 2^-112, where BitLengthRounds takes 1024. Lengths between the rows take the row below,
+ * which has more rounds. For numbers an adversary may pick, use BitLengthRounds or a deterministic test.
+ */
+template <Uint32 errorBits>
+struct ErrorBoundRounds {
+    static constexpr std::size_t column = detail::errorBoundColumn(errorBits);
+
+    static_assert(column < sizeof(detail::errorBoundTargets) / sizeof(detail::errorBoundTargets[0]),
+                  "Invalid template argument for cml::ErrorBoundRounds: errorBits must be 64, 80, 100, 112 or 128");
+
+    static constexpr Uint32 rounds(Uint32 bits)
+    {
+        // Worst case for any composite, also below the first row
+        Uint32 result = (errorBits + 1) / 2;
+        for (const detail::ErrorBoundRow& row : detail::errorBoundRows) {
+            if (row.bits <= bits)
+                result = row.rounds[column];
+        }
+        return result;
+    }
+};
+
+} // namespace cml
\ No newline at end of file
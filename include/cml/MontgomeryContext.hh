@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "LimbArithmetic.hh"
+#include "ResidueArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Residue ring modulo an odd number in Montgomery form
+ * \tparam ValueType Integer type of the modulus and of converted numbers
+ *
+ * A number x is kept as x*R mod n, where R = 2^(limbBits * limbCount()). Conversion costs one
+ * multiplication each way, after that every product is reduced with word multiplications only,
+ * without a full-precision division.
+ */
+template <typename ValueType>
+class MontgomeryContext {
+public:
+    using Value   = ValueType;
+    using Residue = std::vector<Limb>;
+
+    explicit MontgomeryContext(const Value& modulus);
+
+    const Value& modulus() const;
+    std::size_t limbCount() const;
+
+    const Residue& one() const;
+    Residue toResidue(const Value& number) const;
+    Value fromResidue(const Residue& residue) const;
+
+    /**
+     * \brief Conversions into existing objects, which don't allocate once they have grown to the modulus
+     * \param scratch Buffer for the plain number, must not alias \a result or \a residue
+     */
+    void toResidue(Residue& result, const Value& number, Residue& scratch) const;
+    void fromResidue(Value& result, const Residue& residue, Residue& scratch) const;
+
+    /**
+     * \brief result = a * b in Montgomery form
+     * \param result Must not alias \a a or \a b
+     */
+    void multiply(Residue& result, const Residue& a, const Residue& b) const;
+    Residue multiply(const Residue& a, const Residue& b) const;
+
+    template <typename ExpType>
+    Residue power(const Residue& base, const ExpType& exp) const;
+
+    template <typename ExpType>
+    Value modexp(const Value& base, const ExpType& exp) const;
+
+private:
+    // Coarsely integrated operand scanning, result gets limbCount() limbs
+    void montgomeryMultiply(Limb* result, const Limb* a, const Limb* b) const;
+
+    Value m_modulus{};
+    std::vector<Limb> m_modulusLimbs{};
+    Limb m_inverse{ 0 }; // -modulus^(-1) mod 2^limbBits
+    Residue m_one{}; // R mod modulus
+    Residue m_radixSquared{}; // R^2 mod modulus
+    Residue m_unit{}; // plain 1, turns a Montgomery product into the conversion out of the form
+};
+
+template <typename ValueType>
+MontgomeryContext<ValueType>::MontgomeryContext(const Value& modulus) : m_modulus(modulus)
+{
+    if (modulus < 3 || modulus % 2 == 0)
+        throw std::domain_error{ "cml::MontgomeryContext::MontgomeryContext(modulus): Modulus must be odd and "
+                                 "greater than 1" };
+
+    const std::size_t count = limbLength(modulus);
+    m_modulusLimbs.resize(count);
+    detail::exportLimbs(modulus, m_modulusLimbs.data(), count);
+
+    // Newton iteration doubles the number of correct low bits, odd x is its own inverse modulo 8
+    Limb inverse = m_modulusLimbs[0];
+    for (Uint32 bits = 3; bits < limbBits; bits *= 2) {
+        inverse *= Limb{ 2 } - m_modulusLimbs[0] * inverse;
+    }
+    m_inverse = Limb{ 0 } - inverse;
+
+    UnboundedInt wideModulus{};
+    detail::importLimbs(wideModulus, m_modulusLimbs.data(), count);
+
+    UnboundedInt radix = (UnboundedInt{ 1 } << (limbBits * count)) % wideModulus;
+    m_one.resize(count);
+    detail::exportLimbs(radix, m_one.data(), count);
+
+    radix = (radix * radix) % wideModulus;
+    m_radixSquared.resize(count);
+    detail::exportLimbs(radix, m_radixSquared.data(), count);
+
+    m_unit.assign(count, Limb{ 0 });
+    m_unit[0] = 1;
+}
+
+template <typename ValueType>
+const typename MontgomeryContext<ValueType>::Value& MontgomeryContext<ValueType>::modulus() const
+{
+    return m_modulus;
+}
+
+template <typename ValueType>
+std::size_t MontgomeryContext<ValueType>::limbCount() const
+{
+    return m_modulusLimbs.size();
+}
+
+template <typename ValueType>
+const typename MontgomeryContext<ValueType>::Residue& MontgomeryContext<ValueType>::one() const
+{
+    return m_one;
+}
+
+template <typename ValueType>
+typename MontgomeryContext<ValueType>::Residue MontgomeryContext<ValueType>::toResidue(const Value& number) const
+{
+    Residue result{};
+    Residue scratch{};
+    toResidue(result, number, scratch);
+    return result;
+}
+
+template <typename ValueType>
+typename MontgomeryContext<ValueType>::Value MontgomeryContext<ValueType>::fromResidue(const Residue& residue) const
+{
+    Value result{};
+    Residue scratch{};
+    fromResidue(result, residue, scratch);
+    return result;
+}
+
+template <typename ValueType>
+void MontgomeryContext<ValueType>::toResidue(Residue& result, const Value& number, Residue& scratch) const
+{
+    scratch.resize(limbCount());
+    if (number < m_modulus)
+        detail::exportLimbs(number, scratch.data(), scratch.size());
+    else
+        detail::exportLimbs(static_cast<Value>(number % m_modulus), scratch.data(), scratch.size());
+
+    result.resize(limbCount());
+    montgomeryMultiply(result.data(), scratch.data(), m_radixSquared.data());
+}
+
+template <typename ValueType>
+void MontgomeryContext<ValueType>::fromResidue(Value& result, const Residue& residue, Residue& scratch) const
+{
+    scratch.resize(limbCount());
+    montgomeryMultiply(scratch.data(), residue.data(), m_unit.data());
+    detail::importLimbs(result, scratch.data(), scratch.size());
+}
+
+template <typename ValueType>
+void MontgomeryContext<ValueType>::multiply(Residue& result, const Residue& a, const Residue& b) const
+{
+    result.resize(limbCount());
+    montgomeryMultiply(result.data(), a.data(), b.data());
+}
+
+template <typename ValueType>
+typename MontgomeryContext<ValueType>::Residue MontgomeryContext<ValueType>::multiply(const Residue& a,
+                                                                                     const Residue& b) const
+{
+    Residue result(limbCount());
+    montgomeryMultiply(result.data(), a.data(), b.data());
+    return result;
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename MontgomeryContext<ValueType>::Residue MontgomeryContext<ValueType>::power(const Residue& base,
+                                                                                  const ExpType& exp) const
+{
+    return detail::power(*this, base, exp);
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename MontgomeryContext<ValueType>::Value MontgomeryContext<ValueType>::modexp(const Value& base,
+                                                                                 const ExpType& exp) const
+{
+    return fromResidue(power(toResidue(base), exp));
+}
+
+template <typename ValueType>
+void MontgomeryContext<ValueType>::montgomeryMultiply(Limb* result, const Limb* a, const Limb* b) const
+{
+    const std::size_t count = limbCount();
+    const Limb* modulus     = m_modulusLimbs.data();
+
+    // Accumulator is result[0..count) plus the top limb, which stays 0 or 1 between iterations
+    std::fill(result, result + count, Limb{ 0 });
+    Limb top = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        // accumulator = (accumulator + a * b[i] + q * modulus) / 2^limbBits, q clears the lowest limb
+        const DoubleLimb multiplier = b[i];
+
+        DoubleLimb product = a[0] * multiplier + result[0];
+        const DoubleLimb q = static_cast<Limb>(static_cast<Limb>(product) * m_inverse);
+        DoubleLimb reduced = q * modulus[0] + static_cast<Limb>(product);
+
+        Limb productCarry = static_cast<Limb>(product >> limbBits);
+        Limb reducedCarry = static_cast<Limb>(reduced >> limbBits);
+
+        for (std::size_t j = 1; j < count; ++j) {
+            product       = a[j] * multiplier + result[j] + productCarry;
+            reduced       = q * modulus[j] + static_cast<Limb>(product) + reducedCarry;
+            result[j - 1] = static_cast<Limb>(reduced);
+            productCarry  = static_cast<Limb>(product >> limbBits);
+            reducedCarry  = static_cast<Limb>(reduced >> limbBits);
+        }
+
+        const DoubleLimb sum = static_cast<DoubleLimb>(productCarry) + reducedCarry + top;
+        result[count - 1]    = static_cast<Limb>(sum);
+        top                  = static_cast<Limb>(sum >> limbBits);
+    }
+
+    if (top != 0 || detail::compareLimbs(result, modulus, count) >= 0)
+        detail::subtractLimbs(result, result, modulus, count);
+}
+
+} // namespace cml
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <limits>
 #include <random>
+#include <type_traits>
 
 #include <boost/random.hpp>
 #include <boost/random/random_device.hpp>
 
 #include "ContainerByBitness.hh"
+#include "LaunchPolicy.hh"
 #include "RandomGenerator.hh"
 #include "Typedefs.hh"
 
@@ -38,4 +41,51 @@ private:
     Engine m_randomEngine{ boost::random::random_device{}() };
 };
 
+namespace detail {
+
+/**
+ * \brief Random stream of one worker thread: a 64-bit Mersenne twister, seeded from the shared generator
+ *
+ * Only its worker draws from it, so no draw waits for the shared generator's lock. random() gives 64 bits,
+ * bounded draws of any width come from the uniform distribution over the engine's words.
+ */
+template <typename ResultType>
+class WorkerRandomGenerator : public RandomGenerator<ResultType> {
+public:
+    using Base = RandomGenerator<ResultType>;
+    using typename Base::Result;
+
+    explicit WorkerRandomGenerator(Uint64 seed) : m_randomEngine(seed) {}
+
+    Result random() override
+    {
+        return static_cast<Result>(m_randomEngine());
+    }
+
+    Result random(Result min, Result max) override
+    {
+        boost::random::uniform_int_distribution<Result> uid{ min, max };
+        return uid(m_randomEngine);
+    }
+
+private:
+    std::mt19937_64 m_randomEngine;
+};
+
+/**
+ * \brief Seed of a worker's random stream: the low 64 bits of one draw from the shared generator
+ * \param policy Of the draw, LaunchPolicy::Async when other threads may draw from the generator meanwhile
+ */
+template <class RandomGeneratorType>
+Uint64 workerSeed(RandomGeneratorType& randomGenerator, LaunchPolicy policy = LaunchPolicy::Sync)
+{
+    const auto draw = randomGenerator(policy);
+    if constexpr (std::is_integral<std::decay_t<decltype(draw)>>::value)
+        return static_cast<Uint64>(draw);
+    else
+        return static_cast<Uint64>(draw & std::numeric_limits<Uint64>::max());
+}
+
+} // namespace detail
+
 } // namespace cml
\ No newline at end of file
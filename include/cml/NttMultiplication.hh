@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "LimbArithmetic.hh"
+#include "Typedefs.hh"
+#include "WordMontgomeryContext.hh"
+
+namespace cml {
+
+// Crossover measured by the NTT benchmark: below it, in limbs of the shorter operand, cpp_int's own
+// multiplication is faster
+constexpr std::size_t nttMinLimbs = 768;
+
+namespace detail {
+
+/**
+ * \brief Word prime c * 2^k + 1, its field has roots of unity of every order up to 2^k
+ */
+struct NttPrime {
+    Limb modulus;
+    Limb generator; // Primitive root
+    Uint32 twoAdicity; // k
+};
+
+// Product of the primes is about 2^183, above any coefficient of a limb convolution up to 2^55 points
+constexpr NttPrime nttPrimes[] = {
+    { 0x3A00000000000001, 3, 57 }, // 29 * 2^57 + 1
+    { 0x2280000000000001, 5, 55 }, // 69 * 2^55 + 1
+    { 0x1B00000000000001, 5, 56 }, // 27 * 2^56 + 1
+};
+
+/**
+ * \brief Number-theoretic transform of one size modulo one NTT prime
+ *
+ * Transformed values stay plain numbers below the prime, only the roots of unity are in Montgomery form:
+ * a Montgomery product of a plain value and a root is the plain product, without any conversion.
+ */
+class NttTransform {
+public:
+    NttTransform(const NttPrime& prime, std::size_t size);
+
+    const WordMontgomeryContext<Limb>& context() const;
+
+    // Decimation in frequency: natural order in, bit-reversed order out
+    void forward(Limb* values) const;
+
+    // Decimation in time: bit-reversed order in, natural order out, values end up multiplied by size
+    void inverse(Limb* values) const;
+
+    // values[i] * factors[i] * R^-1, undoes the size factor of inverse() and the R^-1 of a Montgomery product
+    void multiplyScaled(Limb* values, const Limb* factors) const;
+
+    // values = limbs modulo the prime, zero-padded to size
+    void reduce(Limb* values, const Limb* limbs, std::size_t count) const;
+
+private:
+    static Limb add(Limb a, Limb b, Limb modulus);
+    static Limb subtract(Limb a, Limb b, Limb modulus);
+
+    WordMontgomeryContext<Limb> m_context;
+    Limb m_modulus{ 0 };
+    std::size_t m_size{ 0 };
+    std::vector<Limb> m_roots{}; // m_roots[half + j] = w^j for w of order 2 * half, Montgomery form
+    std::vector<Limb> m_inverseRoots{};
+    Limb m_scale{ 0 }; // R^2 / size, Montgomery form of R / size
+};
+
+inline NttTransform::NttTransform(const NttPrime& prime, std::size_t size) :
+    m_context(prime.modulus),
+    m_modulus(prime.modulus),
+    m_size(size),
+    m_roots(std::max<std::size_t>(size, 2)),
+    m_inverseRoots(std::max<std::size_t>(size, 2))
+{
+    const Limb generator = m_context.toResidue(prime.generator);
+    const Limb order     = m_modulus - 1;
+
+    // Roots of order size for the top level, every lower level takes every second one of the level above
+    const std::size_t half = std::max<std::size_t>(size / 2, 1);
+    const Limb root        = m_context.power(generator, order / (2 * half));
+    const Limb inverseRoot = m_context.power(root, order - 1);
+
+    m_roots[half]        = m_context.one();
+    m_inverseRoots[half] = m_context.one();
+    for (std::size_t j = 1; j < half; ++j) {
+        m_roots[half + j]        = m_context.multiply(m_roots[half + j - 1], root);
+        m_inverseRoots[half + j] = m_context.multiply(m_inverseRoots[half + j - 1], inverseRoot);
+    }
+    for (std::size_t level = half / 2; level > 0; level /= 2) {
+        for (std::size_t j = 0; j < level; ++j) {
+            m_roots[level + j]        = m_roots[2 * level + 2 * j];
+            m_inverseRoots[level + j] = m_inverseRoots[2 * level + 2 * j];
+        }
+    }
+
+    // size^-1 * R by Fermat, once more into Montgomery form
+    const Limb inverseSize = m_context.power(m_context.toResidue(static_cast<Limb>(size)), order - 1);
+    m_scale                = m_context.toResidue(inverseSize);
+}
+
+inline const WordMontgomeryContext<Limb>& NttTransform::context() const
+{
+    return m_context;
+}
+
+inline void NttTransform::forward(Limb* values) const
+{
+    // Local copies: stores through values could alias the members and force reloads in the inner loop
+    const WordMontgomeryContext<Limb> context = m_context;
+    const Limb modulus                        = m_modulus;
+
+    for (std::size_t half = m_size / 2; half > 0; half /= 2) {
+        const Limb* roots = m_roots.data() + half;
+        for (std::size_t start = 0; start < m_size; start += 2 * half) {
+            Limb* low  = values + start;
+            Limb* high = low + half;
+            for (std::size_t j = 0; j < half; ++j) {
+                const Limb u = low[j];
+                const Limb v = high[j];
+                low[j]       = add(u, v, modulus);
+                high[j]      = context.multiply(subtract(u, v, modulus), roots[j]);
+            }
+        }
+    }
+}
+
+inline void NttTransform::inverse(Limb* values) const
+{
+    const WordMontgomeryContext<Limb> context = m_context;
+    const Limb modulus                        = m_modulus;
+
+    for (std::size_t half = 1; half < m_size; half *= 2) {
+        const Limb* roots = m_inverseRoots.data() + half;
+        for (std::size_t start = 0; start < m_size; start += 2 * half) {
+            Limb* low  = values + start;
+            Limb* high = low + half;
+            for (std::size_t j = 0; j < half; ++j) {
+                const Limb u = low[j];
+                const Limb v = context.multiply(high[j], roots[j]);
+                low[j]       = add(u, v, modulus);
+                high[j]      = subtract(u, v, modulus);
+            }
+        }
+    }
+}
+
+inline void NttTransform::multiplyScaled(Limb* values, const Limb* factors) const
+{
+    const WordMontgomeryContext<Limb> context = m_context;
+    const Limb scale                          = m_scale;
+
+    // (a * b * R^-1) * (R^2 / size) * R^-1 = a * b / size
+    for (std::size_t i = 0; i < m_size; ++i) {
+        values[i] = context.multiply(context.multiply(values[i], factors[i]), scale);
+    }
+}
+
+inline void NttTransform::reduce(Limb* values, const Limb* limbs, std::size_t count) const
+{
+    const WordMontgomeryContext<Limb> context = m_context;
+    const Limb one                            = m_context.one();
+
+    // Montgomery reduction only needs the product below modulus * R, so any limb times R is fine
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i] = context.multiply(limbs[i], one);
+    }
+    std::fill(values + count, values + m_size, Limb{ 0 });
+}
+
+inline Limb NttTransform::add(Limb a, Limb b, Limb modulus)
+{
+    // Primes are below 2^62, the sum can't overflow
+    const Limb sum = a + b;
+    return sum >= modulus ? sum - modulus : sum;
+}
+
+inline Limb NttTransform::subtract(Limb a, Limb b, Limb modulus)
+{
+    return a - b + (a < b ? modulus : Limb{ 0 });
+}
+
+/**
+ * \brief result = a * b by three NTTs and the Chinese remainder theorem, result must not alias a or b
+ * \param result Gets aCount + bCount limbs
+ *
+ * Every limb is one digit, the cyclic convolution of the digits is taken modulo each prime and the exact
+ * coefficients, below 2^183, are rebuilt by Garner's algorithm while the carries are propagated.
+ */
+inline void nttMultiplyLimbs(Limb* result, const Limb* a, std::size_t aCount, const Limb* b, std::size_t bCount)
+{
+    const bool square = a == b && aCount == bCount;
+
+    std::size_t size = 1;
+    while (size < aCount + bCount - 1) {
+        size *= 2;
+    }
+
+    // residues[k][i] = coefficient i of the product modulo prime k
+    std::vector<Limb> residues[3], factors(square ? 0 : size);
+    std::vector<NttTransform> transforms{};
+    transforms.reserve(3);
+
+    for (std::size_t k = 0; k < 3; ++k) {
+        const NttTransform& transform = transforms.emplace_back(nttPrimes[k], size);
+
+        std::vector<Limb>& values = residues[k];
+        values.resize(size);
+        transform.reduce(values.data(), a, aCount);
+        transform.forward(values.data());
+
+        if (square) {
+            transform.multiplyScaled(values.data(), values.data());
+        }
+        else {
+            transform.reduce(factors.data(), b, bCount);
+            transform.forward(factors.data());
+            transform.multiplyScaled(values.data(), factors.data());
+        }
+
+        transform.inverse(values.data());
+    }
+
+    const Limb p1 = nttPrimes[0].modulus, p2 = nttPrimes[1].modulus, p3 = nttPrimes[2].modulus;
+    const auto& context2 = transforms[1].context();
+    const auto& context3 = transforms[2].context();
+
+    // Garner's constants in Montgomery form, a Montgomery product with them is the plain product
+    const DoubleLimb p1p2   = static_cast<DoubleLimb>(p1) * p2;
+    const Limb p1Inverse2   = context2.power(context2.toResidue(p1), p2 - 2);
+    const Limb p1Modulo3    = context3.toResidue(p1);
+    const Limb p1p2Inverse3 = context3.power(context3.toResidue(static_cast<Limb>(p1p2 % p3)), p3 - 2);
+    const Limb p1p2Low      = static_cast<Limb>(p1p2);
+    const Limb p1p2High     = static_cast<Limb>(p1p2 >> limbBits);
+    const Limb one2         = context2.one();
+    const Limb one3         = context3.one();
+
+    std::fill(result, result + aCount + bCount, Limb{ 0 });
+
+    // Running carry, three limbs
+    Limb carry0 = 0, carry1 = 0, carry2 = 0;
+    for (std::size_t i = 0; i < aCount + bCount; ++i) {
+        if (i < aCount + bCount - 1) {
+            const Limb r1 = residues[0][i], r2 = residues[1][i], r3 = residues[2][i];
+
+            // coefficient = r1 + p1 * t2 + p1 * p2 * t3. Products with a Montgomery constant also reduce
+            // operands up to 2^64, so r1 and t2 need no reduction modulo the smaller primes
+            const Limb t2 = context2.multiply(r2 + p2 - context2.multiply(r1, one2), p1Inverse2);
+
+            Limb known    = context3.multiply(r1, one3) + context3.multiply(t2, p1Modulo3);
+            known         = known >= p3 ? known - p3 : known;
+            const Limb t3 = context3.multiply(r3 + p3 - known, p1p2Inverse3);
+
+            // Three limb sum of the carry and the coefficient
+            const DoubleLimb low    = static_cast<DoubleLimb>(p1) * t2 + r1;
+            const DoubleLimb middle = static_cast<DoubleLimb>(p1p2Low) * t3;
+            const DoubleLimb high   = static_cast<DoubleLimb>(p1p2High) * t3;
+
+            DoubleLimb sum = static_cast<DoubleLimb>(carry0) + static_cast<Limb>(low) + static_cast<Limb>(middle);
+            carry0         = static_cast<Limb>(sum);
+            sum            = (sum >> limbBits) + carry1 + static_cast<Limb>(low >> limbBits) +
+                  static_cast<Limb>(middle >> limbBits) + static_cast<Limb>(high);
+            carry1 = static_cast<Limb>(sum);
+            carry2 = static_cast<Limb>((sum >> limbBits) + carry2 + static_cast<Limb>(high >> limbBits));
+        }
+
+        result[i] = carry0;
+        carry0    = carry1;
+        carry1    = carry2;
+        carry2    = 0;
+    }
+}
+
+} // namespace detail
+
+/**
+ * \brief Exact product, by number-theoretic transforms for operands of at least nttMinLimbs limbs
+ *
+ * Quasi-linear in the operand size where cpp_int's multiplication is quadratic. A number multiplied by
+ * itself is transformed once.
+ */
+inline UnboundedInt mulLarge(const UnboundedInt& a, const UnboundedInt& b)
+{
+    if (a < 0 || b < 0) {
+        if (&a == &b) {
+            const UnboundedInt magnitude = -a;
+            return mulLarge(magnitude, magnitude);
+        }
+
+        UnboundedInt result = mulLarge(UnboundedInt{ abs(a) }, UnboundedInt{ abs(b) });
+        if ((a < 0) != (b < 0))
+            result = -result;
+        return result;
+    }
+
+    const std::size_t aCount = limbLength(a);
+    const std::size_t bCount = limbLength(b);
+    if (std::min(aCount, bCount) < nttMinLimbs)
+        return a * b;
+
+    std::vector<Limb> aLimbs(aCount), bLimbs(&a == &b ? 0 : bCount), product(aCount + bCount);
+    detail::exportLimbs(a, aLimbs.data(), aCount);
+    const Limb* bData = aLimbs.data();
+    if (&a != &b) {
+        detail::exportLimbs(b, bLimbs.data(), bCount);
+        bData = bLimbs.data();
+    }
+
+    detail::nttMultiplyLimbs(product.data(), aLimbs.data(), aCount, bData, bCount);
+
+    UnboundedInt result{};
+    detail::importLimbs(result, product.data(), product.size());
+    return result;
+}
+
+} // namespace cml
\ No newline at end of file
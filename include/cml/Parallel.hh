@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cml {
+namespace detail {
+
+// Threads for count independent tasks: one per hardware thread, no more than tasks
+inline std::size_t workerCount(std::size_t count)
+{
+    const std::size_t hardware = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<std::size_t>(std::min(hardware, count), 1);
+}
+
+/**
+ * \brief Runs task(state, index) for every index below count, spread over workerCount(count) threads
+ * \param makeState Called as makeState(worker) on the calling thread for every worker before any starts,
+ * the state is the worker's own, a random stream for example
+ * \return false as soon as a task returns false, the indices not yet started are skipped then
+ *
+ * The calling thread is one of the workers. An exception of a task stops the others the same way and is
+ * rethrown here.
+ */
+template <class MakeState, class Task>
+bool parallelAll(std::size_t count, MakeState&& makeState, Task&& task)
+{
+    const std::size_t workers = workerCount(count);
+
+    using State = decltype(makeState(std::size_t{ 0 }));
+    std::vector<State> states{};
+    states.reserve(workers);
+    for (std::size_t worker = 0; worker < workers; ++worker) {
+        states.push_back(makeState(worker));
+    }
+
+    std::atomic<std::size_t> next{ 0 };
+    std::atomic<bool> stopped{ false };
+    std::exception_ptr error{};
+    std::mutex errorMutex{};
+
+    const auto work = [&](State& state) {
+        try {
+            for (std::size_t index = next++; index < count && !stopped; index = next++) {
+                if (!task(state, index))
+                    stopped = true;
+            }
+        }
+        catch (...) {
+            std::unique_lock<std::mutex> lock{ errorMutex };
+            if (!error)
+                error = std::current_exception();
+            stopped = true;
+        }
+    };
+
+    std::vector<std::thread> threads{};
+    threads.reserve(workers - 1);
+    for (std::size_t worker = 1; worker < workers; ++worker) {
+        threads.emplace_back(work, std::ref(states[worker]));
+    }
+    work(states[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+    return !stopped;
+}
+
+} // namespace detail
+} // namespace cml
\ No newline at end of file
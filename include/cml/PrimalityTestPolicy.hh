@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Algorithms.hh"
+#include "BailliePswTest.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Primality test of the prime generators: random-base Miller-Rabin rounds
+ *
+ * A test policy provides static test(number, rounds, randomGenerator), true for a prime or a probable one.
+ */
+struct MillerRabinPolicy {
+    template <typename T, class RandomGenerator>
+    static bool test(const T& number, Uint32 rounds, RandomGenerator& randomGenerator)
+    {
+        return millerRabinTest(number, rounds, randomGenerator);
+    }
+};
+
+/**
+ * \brief Primality test of the prime generators: Baillie-PSW, the round count and the random generator are
+ * unused
+ */
+struct BailliePswPolicy {
+    template <typename T, class RandomGenerator>
+    static bool test(const T& number, Uint32 /* rounds */, RandomGenerator& /* randomGenerator */)
+    {
+        return bailliePswTest(number);
+    }
+};
+
+} // namespace cml
\ No newline at end of file
@@ -17,10 +17,10 @@ public:
     Result operator()(LaunchPolicy policy = LaunchPolicy::Sync)
     {
         switch (policy) {
-            case LaunchPolicy::Async: {
-                std::unique_lock<std::mutex> lock{ m_mutex };
-                return generate();
-            }
+            case LaunchPolicy::Async:
+                return generateAsync();
+            case LaunchPolicy::Parallel:
+                return generateParallel();
             case LaunchPolicy::Sync:
                 return generate();
             default:
@@ -30,8 +30,31 @@ public:
         return Result{};
     }
 
+protected:
+    // The lock of LaunchPolicy::Async, for overrides that share state with generate()
+    std::unique_lock<std::mutex> lock()
+    {
+        return std::unique_lock<std::mutex>{ m_mutex };
+    }
+
 private:
     virtual Result generate() = 0;
+
+    // As generate, for callers on several threads. Generators whose generate() is thread-safe skip the lock
+    virtual Result generateAsync()
+    {
+        const std::unique_lock<std::mutex> lock = this->lock();
+        return generate();
+    }
+
+    // As generate, may search on several threads. Generators without a parallel search keep to one as
+    // LaunchPolicy::Async; overrides lock only around what they share with generate(), so callers on
+    // several threads search at once
+    virtual Result generateParallel()
+    {
+        return generateAsync();
+    }
+
     std::mutex m_mutex{};
 };
 
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "BoundedMpmcQueue.hh"
+#include "IsPrimeGenerator.hh"
+#include "PrimeGenerator.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Counters of a PrimePool, read at one moment
+ */
+struct PrimePoolMetrics {
+    std::size_t depth{ 0 }; // Primes ready in the queue
+    Uint64 pooled{ 0 }; // Primes the background threads generated
+    Uint64 served{ 0 }; // Requests served from the queue
+    Uint64 generatedInline{ 0 }; // Requests that found the queue empty and generated on the caller's thread
+    double refillSeconds{ 0 }; // Time the background threads spent generating, summed over the threads
+    std::size_t workerCount{ 0 };
+
+    // Primes per second the pool gains while all background threads generate
+    double refillRate() const
+    {
+        return refillSeconds > 0 ? static_cast<double>(pooled) * static_cast<double>(workerCount) / refillSeconds
+                                 : 0;
+    }
+};
+
+/**
+ * \brief Prime generator that hands out primes generated ahead by background threads
+ * \tparam PrimeGeneratorType Generator of the primes, each background thread has its own
+ *
+ * Generation time is heavy-tailed, the pool takes it off the caller's path: a request pops a ready prime
+ * from a lock-free queue in constant time, and generates inline only when the queue is empty. When a
+ * request leaves fewer than lowWatermark primes, the background threads wake up and fill the queue up to
+ * highWatermark, then sleep again.
+ *
+ * Requests are thread-safe with any launch policy. Each calling thread generates inline with a generator of
+ * its own, so requests on several threads that find the queue empty generate at once.
+ * The destructor waits for the primes under way, so for large primes it takes up to one generation time.
+ */
+template <class PrimeGeneratorType>
+class PrimePool : public PrimeGenerator<typename PrimeGeneratorType::Result> {
+public:
+    static_assert(IsPrimeGenerator<PrimeGeneratorType>::value,
+                  "Invalid template argument for cml::PrimePool: PrimeGeneratorType interface is not suitable");
+
+    using Base      = PrimeGenerator<typename PrimeGeneratorType::Result>;
+    using Generator = PrimeGeneratorType;
+    using typename Base::Result;
+
+    PrimePool();
+
+    /**
+     * \param lowWatermark Refill starts when a request leaves fewer primes ready, at least 1
+     * \param highWatermark Refill stops at this many ready primes, at least lowWatermark
+     * \param workerCount Background threads, at least 1
+     */
+    PrimePool(std::size_t lowWatermark, std::size_t highWatermark, std::size_t workerCount = 1);
+
+    ~PrimePool() override;
+
+    PrimePool(const PrimePool&)            = delete;
+    PrimePool& operator=(const PrimePool&) = delete;
+
+    PrimePoolMetrics metrics() const;
+
+private:
+    Result generate() override;
+
+    // generate() is thread-safe, requests on several threads skip the lock of the base
+    Result generateAsync() override;
+
+    // Background thread: generates while a refill is on, sleeps otherwise
+    void refill(Generator& primeGenerator);
+
+    // Called after taking a prime out, wakes the background threads below the low watermark
+    void checkLowWatermark();
+
+    std::size_t m_lowWatermark;
+    std::size_t m_highWatermark;
+
+    // Every background thread pushes at most one prime past the high watermark, there is room for it
+    detail::BoundedMpmcQueue<Result> m_queue;
+
+    // Guard the refill flag and the wake-ups only, the queue needs no lock
+    std::mutex m_refillMutex{};
+    std::condition_variable m_refillCondition{};
+    bool m_refilling = true;
+    bool m_stopped   = false;
+
+    std::atomic<Uint64> m_pooled{ 0 };
+    std::atomic<Uint64> m_served{ 0 };
+    std::atomic<Uint64> m_generatedInline{ 0 };
+    std::atomic<Uint64> m_refillNanoseconds{ 0 };
+
+    std::vector<std::unique_ptr<Generator>> m_generators{};
+    std::vector<std::thread> m_workers{};
+};
+
+template <class PrimeGeneratorType>
+PrimePool<PrimeGeneratorType>::PrimePool() : PrimePool(2, 8)
+{}
+
+template <class PrimeGeneratorType>
+PrimePool<PrimeGeneratorType>::PrimePool(std::size_t lowWatermark, std::size_t highWatermark, std::size_t workerCount) :
+    m_lowWatermark(lowWatermark), m_highWatermark(highWatermark), m_queue(highWatermark + workerCount)
+{
+    if (lowWatermark == 0 || lowWatermark > highWatermark)
+        throw std::domain_error{ "cml::PrimePool::PrimePool(lowWatermark, highWatermark, workerCount): Invalid "
+                                 "watermarks" };
+    if (workerCount == 0)
+        throw std::domain_error{ "cml::PrimePool::PrimePool(lowWatermark, highWatermark, workerCount): No workers" };
+
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        m_generators.push_back(std::make_unique<Generator>());
+    }
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&PrimePool::refill, this, std::ref(*m_generators[i]));
+    }
+}
+
+template <class PrimeGeneratorType>
+PrimePool<PrimeGeneratorType>::~PrimePool()
+{
+    {
+        std::unique_lock<std::mutex> lock{ m_refillMutex };
+        m_stopped = true;
+    }
+    m_refillCondition.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+template <class PrimeGeneratorType>
+PrimePoolMetrics PrimePool<PrimeGeneratorType>::metrics() const
+{
+    PrimePoolMetrics result{};
+    result.depth           = m_queue.size();
+    result.pooled          = m_pooled;
+    result.served          = m_served;
+    result.generatedInline = m_generatedInline;
+    result.refillSeconds   = static_cast<double>(m_refillNanoseconds) * 1e-9;
+    result.workerCount     = m_workers.size();
+    return result;
+}
+
+template <class PrimeGeneratorType>
+typename PrimePool<PrimeGeneratorType>::Result PrimePool<PrimeGeneratorType>::generate()
+{
+    Result prime{};
+    if (m_queue.pop(prime)) {
+        ++m_served;
+        checkLowWatermark();
+        return prime;
+    }
+
+    ++m_generatedInline;
+    checkLowWatermark();
+
+    // One per calling thread, shared by the pools of this generator type
+    thread_local Generator inlineGenerator{};
+    return inlineGenerator();
+}
+
+template <class PrimeGeneratorType>
+typename PrimePool<PrimeGeneratorType>::Result PrimePool<PrimeGeneratorType>::generateAsync()
+{
+    return generate();
+}
+
+template <class PrimeGeneratorType>
+void PrimePool<PrimeGeneratorType>::refill(Generator& primeGenerator)
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{ m_refillMutex };
+            m_refillCondition.wait(lock, [this] { return m_stopped || m_refilling; });
+            if (m_stopped)
+                return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        Result prime     = primeGenerator();
+        const auto stop  = std::chrono::steady_clock::now();
+
+        m_refillNanoseconds += static_cast<Uint64>(std::chrono::nanoseconds{ stop - start }.count());
+        if (m_queue.push(prime))
+            ++m_pooled;
+
+        // Checked under the lock: a request that drops below the low watermark in between sets the flag
+        // again after this
+        std::unique_lock<std::mutex> lock{ m_refillMutex };
+        if (m_queue.size() >= m_highWatermark)
+            m_refilling = false;
+    }
+}
+
+template <class PrimeGeneratorType>
+void PrimePool<PrimeGeneratorType>::checkLowWatermark()
+{
+    if (m_queue.size() >= m_lowWatermark)
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock{ m_refillMutex };
+        m_refilling = true;
+    }
+    m_refillCondition.notify_all();
+}
+
+} // namespace cml
\ No newline at end of file
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "DeterministicPrimality.hh"
+#include "Parallel.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+// Bytes of one sieve segment, the L1 data cache of most cores: crossing off never leaves it
+constexpr std::size_t sieveSegmentBytes = 32 * 1024;
+
+namespace detail {
+
+constexpr Uint64 sieveSegmentBits = Uint64{ sieveSegmentBytes } * 8;
+
+// Segments a parallel task sieves one after another, the start offsets take a division per prime per task
+constexpr Uint64 sieveSegmentsPerTask = 16;
+
+// floor(sqrt(number)), the double estimate corrected by a unit either way
+inline Uint64 integerSqrt(Uint64 number)
+{
+    Uint64 root = std::min<Uint64>(static_cast<Uint64>(std::sqrt(static_cast<double>(number))), 0xFFFFFFFF);
+    while (root * root > number) {
+        --root;
+    }
+    while (root < 0xFFFFFFFF && (root + 1) * (root + 1) <= number) {
+        ++root;
+    }
+    return root;
+}
+
+/**
+ * \brief Segmented sieve of Eratosthenes over the odd numbers of [low, high)
+ *
+ * A segment holds sieveSegmentBits odd numbers as bits, set for composites. Every sieving prime keeps the
+ * offset of its next odd multiple, so moving to the next segment costs no division. The primes are passed
+ * in on every call, several sieves share one list.
+ */
+class SegmentedSieve {
+public:
+    /**
+     * \brief Starts a new range, the next call to next() sieves its first segment
+     * \param primes Odd primes up to at least sqrt(high - 1), ascending
+     * \param low Odd
+     */
+    void seek(const std::vector<Uint32>& primes, Uint64 low, Uint64 high);
+
+    // Sieves the next segment, false if the range is exhausted
+    bool next(const std::vector<Uint32>& primes);
+
+    // First number of the sieved segment
+    Uint64 low() const;
+
+    // Odd numbers in the sieved segment
+    std::size_t size() const;
+
+    // Whether low() + 2 * index is prime
+    bool isPrime(std::size_t index) const;
+
+    // Primes in the sieved segment
+    std::size_t count() const;
+
+private:
+    std::vector<Uint64> m_offsets{};
+    std::vector<Uint64> m_bits = std::vector<Uint64>(sieveSegmentBits / 64);
+    Uint64 m_next = 1;
+    Uint64 m_high = 1;
+    Uint64 m_low  = 1;
+    std::size_t m_size = 0;
+};
+
+inline void SegmentedSieve::seek(const std::vector<Uint32>& primes, Uint64 low, Uint64 high)
+{
+    m_next = low;
+    m_high = std::max(low, high);
+    m_low  = low;
+    m_size = 0;
+
+    // Offset of the first odd multiple from p^2 on, smaller multiples have a smaller prime factor
+    m_offsets.resize(primes.size());
+    for (std::size_t i = 0; i < primes.size(); ++i) {
+        const Uint64 prime = primes[i];
+        const Uint64 rest  = low % prime;
+
+        Uint64 distance = rest == 0 ? 0 : prime - rest;
+        if (distance % 2 != 0)
+            distance += prime;
+        m_offsets[i] = prime * prime > low ? (prime * prime - low) / 2 : distance / 2;
+    }
+}
+
+inline bool SegmentedSieve::next(const std::vector<Uint32>& primes)
+{
+    m_low  = m_next;
+    m_size = static_cast<std::size_t>(std::min(sieveSegmentBits, (m_high - m_low + 1) / 2));
+    if (m_size == 0)
+        return false;
+    m_next = m_low + 2 * Uint64{ m_size };
+
+    std::fill(m_bits.begin(), m_bits.begin() + static_cast<std::ptrdiff_t>((m_size + 63) / 64), Uint64{ 0 });
+    if (m_low == 1)
+        m_bits[0] = 1;
+
+    for (std::size_t i = 0; i < primes.size(); ++i) {
+        const Uint64 prime = primes[i];
+
+        Uint64 offset = m_offsets[i];
+        for (; offset < m_size; offset += prime) {
+            m_bits[offset / 64] |= Uint64{ 1 } << (offset % 64);
+        }
+        m_offsets[i] = offset - m_size;
+    }
+    return true;
+}
+
+inline Uint64 SegmentedSieve::low() const
+{
+    return m_low;
+}
+
+inline std::size_t SegmentedSieve::size() const
+{
+    return m_size;
+}
+
+inline bool SegmentedSieve::isPrime(std::size_t index) const
+{
+    return ((m_bits[index / 64] >> (index % 64)) & 1) == 0;
+}
+
+inline std::size_t SegmentedSieve::count() const
+{
+    std::size_t composites = 0;
+    for (std::size_t word = 0; word < m_size / 64; ++word) {
+        composites += std::bitset<64>{ m_bits[word] }.count();
+    }
+    if (m_size % 64 != 0)
+        composites += std::bitset<64>{ m_bits[m_size / 64] & ((Uint64{ 1 } << (m_size % 64)) - 1) }.count();
+    return m_size - composites;
+}
+
+// Odd primes up to limit: the constant table below 2^16, a segmented sieve by the table's primes above
+inline std::vector<Uint32> sievingPrimes(Uint64 limit)
+{
+    std::vector<Uint32> primes{};
+    for (Uint32 number = 3; number < smallPrimeTableLimit && number <= limit; number += 2) {
+        if (((smallOddPrimes[number / 128] >> (number / 2 % 64)) & 1) != 0)
+            primes.push_back(number);
+    }
+    if (limit < smallPrimeTableLimit)
+        return primes;
+
+    const std::vector<Uint32> tablePrimes = primes;
+
+    SegmentedSieve sieve{};
+    sieve.seek(tablePrimes, smallPrimeTableLimit + 1, limit + 1);
+    while (sieve.next(tablePrimes)) {
+        for (std::size_t i = 0; i < sieve.size(); ++i) {
+            if (sieve.isPrime(i))
+                primes.push_back(static_cast<Uint32>(sieve.low() + 2 * i));
+        }
+    }
+    return primes;
+}
+
+} // namespace detail
+
+/**
+ * \brief The primes of [lo, hi) in ascending order, sieved a cache-sized segment at a time as the
+ * iteration goes
+ *
+ * An input range: iterators point into the range object, which must outlive them, and begin() restarts
+ * the sieve. Construction sieves the primes up to sqrt(hi), which for hi near 2^64 takes seconds and
+ * gigabytes; the segments take sieveSegmentBytes whatever the range.
+ */
+class PrimeRange {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = Uint64;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Uint64*;
+        using reference         = const Uint64&;
+
+        Iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+
+    private:
+        friend class PrimeRange;
+
+        explicit Iterator(PrimeRange* range);
+
+        PrimeRange* m_range = nullptr; // nullptr past the last prime
+    };
+
+    PrimeRange(Uint64 lo, Uint64 hi);
+
+    Iterator begin();
+    Iterator end();
+
+private:
+    // Moves m_prime to the next prime, false if there is none
+    bool advance();
+
+    Uint64 m_lo;
+    Uint64 m_hi;
+    std::vector<Uint32> m_primes{};
+    detail::SegmentedSieve m_sieve{};
+    std::size_t m_index = 0; // Next bit of the sieved segment
+    Uint64 m_prime      = 0;
+};
+
+inline PrimeRange::Iterator::Iterator(PrimeRange* range) : m_range(range) {}
+
+inline PrimeRange::Iterator::reference PrimeRange::Iterator::operator*() const
+{
+    return m_range->m_prime;
+}
+
+inline PrimeRange::Iterator::pointer PrimeRange::Iterator::operator->() const
+{
+    return &m_range->m_prime;
+}
+
+inline PrimeRange::Iterator& PrimeRange::Iterator::operator++()
+{
+    if (!m_range->advance())
+        m_range = nullptr;
+    return *this;
+}
+
+inline PrimeRange::Iterator PrimeRange::Iterator::operator++(int)
+{
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+inline bool PrimeRange::Iterator::operator==(const Iterator& other) const
+{
+    return m_range == other.m_range;
+}
+
+inline bool PrimeRange::Iterator::operator!=(const Iterator& other) const
+{
+    return m_range != other.m_range;
+}
+
+inline PrimeRange::PrimeRange(Uint64 lo, Uint64 hi) :
+    m_lo(lo), m_hi(hi), m_primes(detail::sievingPrimes(hi > 0 ? detail::integerSqrt(hi - 1) : 0))
+{}
+
+inline PrimeRange::Iterator PrimeRange::begin()
+{
+    // The sieve holds the odd numbers only, 2 comes first on its own
+    m_sieve.seek(m_primes, m_lo | 1, m_hi);
+    m_index = 0;
+    if (m_lo <= 2 && m_hi > 2) {
+        m_prime = 2;
+        return Iterator{ this };
+    }
+    return advance() ? Iterator{ this } : end();
+}
+
+inline PrimeRange::Iterator PrimeRange::end()
+{
+    return Iterator{};
+}
+
+inline bool PrimeRange::advance()
+{
+    while (true) {
+        while (m_index < m_sieve.size()) {
+            const std::size_t index = m_index++;
+            if (m_sieve.isPrime(index)) {
+                m_prime = m_sieve.low() + 2 * Uint64{ index };
+                return true;
+            }
+        }
+        if (!m_sieve.next(m_primes))
+            return false;
+        m_index = 0;
+    }
+}
+
+/**
+ * \brief Lazy range of the primes in [lo, hi)
+ *
+ * for (Uint64 prime : primesInRange(lo, hi)) visits them in ascending order without storing them. The
+ * segments are sieved on the iterating thread one at a time, as the iteration reaches them; countPrimes
+ * spreads them over threads.
+ */
+inline PrimeRange primesInRange(Uint64 lo, Uint64 hi)
+{
+    return PrimeRange{ lo, hi };
+}
+
+/**
+ * \brief Number of primes in [lo, hi)
+ *
+ * The segments are sieved on all hardware threads, each worker with its own segment and offsets over the
+ * shared sieving primes, so the count scales with cores where the segments stay in cache.
+ */
+inline Uint64 countPrimes(Uint64 lo, Uint64 hi)
+{
+    if (hi <= lo)
+        return 0;
+
+    const Uint64 two = lo <= 2 && hi > 2 ? 1 : 0;
+    const Uint64 low = lo | 1;
+    if (low >= hi)
+        return two;
+
+    const std::vector<Uint32> primes = detail::sievingPrimes(detail::integerSqrt(hi - 1));
+
+    const Uint64 taskSpan = 2 * detail::sieveSegmentBits * detail::sieveSegmentsPerTask;
+    const Uint64 tasks    = (hi - low - 1) / taskSpan + 1;
+
+    std::atomic<Uint64> total{ two };
+    detail::parallelAll(
+        static_cast<std::size_t>(tasks),
+        [](std::size_t) { return detail::SegmentedSieve{}; },
+        [&](detail::SegmentedSieve& sieve, std::size_t task) {
+            const Uint64 start = low + task * taskSpan;
+            sieve.seek(primes, start, hi - start > taskSpan ? start + taskSpan : hi);
+
+            Uint64 count = 0;
+            while (sieve.next(primes)) {
+                count += sieve.count();
+            }
+            total += count;
+            return true;
+        });
+    return total;
+}
+
+} // namespace cml
\ No newline at end of file
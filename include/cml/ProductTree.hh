@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "LimbArithmetic.hh"
+#include "NttMultiplication.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+// Crossover of the remainder tree: below it, in limbs of the divisor, cpp_int's own division is faster than
+// a Newton reciprocal and two products
+constexpr std::size_t newtonDivisionMinLimbs = 1024;
+
+namespace detail {
+
+/**
+ * \brief floor(2^(2 * bits) / divisor) for a divisor of exactly \a bits bits
+ *
+ * Newton's iteration x' = 2 * x - divisor * x^2 / 2^(2 * bits) from the reciprocal of the top half of the
+ * divisor doubles the correct bits, so the cost is a few products of the divisor's size.
+ */
+inline UnboundedInt reciprocal(const UnboundedInt& divisor, Uint32 bits)
+{
+    if (bits <= newtonDivisionMinLimbs * limbBits) {
+        const std::size_t divisorCount = limbLength(divisor);
+        const std::size_t numberCount  = 2 * bits / limbBits + 1;
+
+        std::vector<Limb> number(numberCount + 1, 0), divisorLimbs(divisorCount);
+        std::vector<Limb> quotient(numberCount - divisorCount + 1);
+        number[2 * bits / limbBits] = Limb{ 1 } << (2 * bits % limbBits);
+        exportLimbs(divisor, divisorLimbs.data(), divisorCount);
+        divideLimbs(quotient.data(), number.data(), numberCount, divisorLimbs.data(), divisorCount);
+
+        UnboundedInt result{};
+        importLimbs(result, quotient.data(), quotient.size());
+        return result;
+    }
+
+    // Relative error of the half-size start is about 2^(1 - high), after the step the absolute error is a
+    // few units
+    const Uint32 high = bits / 2 + 1;
+    const Uint32 low  = bits - high;
+
+    UnboundedInt x = reciprocal(UnboundedInt{ divisor >> low }, high) << low;
+    x              = (x << 1) - (mulLarge(divisor, mulLarge(x, x)) >> (2 * bits));
+
+    UnboundedInt remainder = (UnboundedInt{ 1 } << (2 * bits)) - mulLarge(divisor, x);
+    while (remainder < 0) {
+        --x;
+        remainder += divisor;
+    }
+    while (remainder >= divisor) {
+        ++x;
+        remainder -= divisor;
+    }
+    return x;
+}
+
+/**
+ * \brief number mod divisor by Barrett reduction, for a number below 2^(2 * bits)
+ * \param inverse reciprocal(divisor, bits)
+ */
+inline UnboundedInt barrettReduce(const UnboundedInt& number,
+                                  const UnboundedInt& divisor,
+                                  const UnboundedInt& inverse,
+                                  Uint32 bits)
+{
+    // The estimate is at most two below the quotient
+    const UnboundedInt quotient = mulLarge(UnboundedInt{ number >> (bits - 1) }, inverse) >> (bits + 1);
+
+    UnboundedInt remainder = number - mulLarge(quotient, divisor);
+    while (remainder >= divisor) {
+        remainder -= divisor;
+    }
+    return remainder;
+}
+
+/**
+ * \brief number mod divisor, for a positive divisor and a non-negative number of any length
+ *
+ * Small divisors go to cpp_int, large ones to Barrett reduction with a Newton reciprocal, which is
+ * quasi-linear where cpp_int's division is quadratic. A number longer than twice the divisor is reduced from
+ * the top, 2 * bits bits at a time.
+ */
+inline UnboundedInt remainderLarge(UnboundedInt number, const UnboundedInt& divisor)
+{
+    if (number < divisor)
+        return number;
+    if (limbLength(divisor) < newtonDivisionMinLimbs) {
+        std::vector<Limb> numberLimbs(limbLength(number) + 1), divisorLimbs(limbLength(divisor));
+        exportLimbs(number, numberLimbs.data(), numberLimbs.size() - 1);
+        exportLimbs(divisor, divisorLimbs.data(), divisorLimbs.size());
+        divideLimbs(nullptr, numberLimbs.data(), numberLimbs.size() - 1, divisorLimbs.data(), divisorLimbs.size());
+
+        UnboundedInt remainder{};
+        importLimbs(remainder, numberLimbs.data(), divisorLimbs.size());
+        return remainder;
+    }
+
+    const Uint32 bits          = bitLength(divisor);
+    const UnboundedInt inverse = reciprocal(divisor, bits);
+    for (Uint32 length = bitLength(number); length > 2 * bits; length = bitLength(number)) {
+        // The top is replaced by its remainder, which removes at least bits bits
+        const Uint32 shift     = length - 2 * bits;
+        const UnboundedInt top = barrettReduce(UnboundedInt{ number >> shift }, divisor, inverse, bits);
+        number                 = (top << shift) | (number & ((UnboundedInt{ 1 } << shift) - 1));
+    }
+    return barrettReduce(number, divisor, inverse, bits);
+}
+
+} // namespace detail
+
+/**
+ * \brief Product tree: numbers at the leaves, every inner node the product of its two children
+ *
+ * Gives the product of all leaves and, by a remainder tree, a number modulo every leaf: the remainder
+ * modulo a node is reduced modulo its children on the way down. Products and remainders at the top are
+ * as long as all leaves together and go through mulLarge and Newton division, so both take quasi-linear
+ * time in the total length, where reducing the number modulo each leaf in turn is quadratic.
+ */
+class ProductTree {
+public:
+    /**
+     * \param leaves Positive numbers
+     */
+    explicit ProductTree(std::vector<UnboundedInt> leaves);
+
+    std::size_t leafCount() const;
+    const UnboundedInt& leaf(std::size_t index) const;
+
+    // Product of all leaves
+    const UnboundedInt& root() const;
+
+    // number mod each leaf, in leaf order
+    std::vector<UnboundedInt> remainders(const UnboundedInt& number) const;
+
+private:
+    // Leaves first, the root last. Node i of a level is the product of nodes 2i and 2i + 1 of the level
+    // below, or a copy of node 2i if that is the last one
+    std::vector<std::vector<UnboundedInt>> m_levels{};
+};
+
+inline ProductTree::ProductTree(std::vector<UnboundedInt> leaves)
+{
+    if (leaves.empty())
+        throw std::domain_error{ "cml::ProductTree::ProductTree(leaves): No leaves" };
+    for (const UnboundedInt& leaf : leaves) {
+        if (leaf < 1)
+            throw std::domain_error{ "cml::ProductTree::ProductTree(leaves): Leaves must be positive" };
+    }
+
+    m_levels.push_back(std::move(leaves));
+    while (m_levels.back().size() > 1) {
+        const std::vector<UnboundedInt>& below = m_levels.back();
+
+        std::vector<UnboundedInt> level{};
+        level.reserve((below.size() + 1) / 2);
+        for (std::size_t i = 0; i + 1 < below.size(); i += 2) {
+            level.push_back(mulLarge(below[i], below[i + 1]));
+        }
+        if (below.size() % 2 != 0)
+            level.push_back(below.back());
+
+        m_levels.push_back(std::move(level));
+    }
+}
+
+inline std::size_t ProductTree::leafCount() const
+{
+    return m_levels.front().size();
+}
+
+inline const UnboundedInt& ProductTree::leaf(std::size_t index) const
+{
+    return m_levels.front()[index];
+}
+
+inline const UnboundedInt& ProductTree::root() const
+{
+    return m_levels.back().front();
+}
+
+inline std::vector<UnboundedInt> ProductTree::remainders(const UnboundedInt& number) const
+{
+    std::vector<UnboundedInt> current{ detail::remainderLarge(number, root()) };
+    for (std::size_t level = m_levels.size() - 1; level-- > 0;) {
+        const std::vector<UnboundedInt>& nodes = m_levels[level];
+
+        std::vector<UnboundedInt> next(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            next[i] = detail::remainderLarge(current[i / 2], nodes[i]);
+        }
+        current = std::move(next);
+    }
+    return current;
+}
+
+} // namespace cml
\ No newline at end of file
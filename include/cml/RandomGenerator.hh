@@ -17,7 +17,8 @@ public:
     Result operator()(LaunchPolicy policy = LaunchPolicy::Sync)
     {
         switch (policy) {
-            case LaunchPolicy::Async: {
+            case LaunchPolicy::Async:
+            case LaunchPolicy::Parallel: {
                 std::unique_lock<std::mutex> lock{ m_mutex };
                 return random();
             }
@@ -33,7 +34,8 @@ public:
     Result operator()(Result min, Result max, LaunchPolicy policy = LaunchPolicy::Sync)
     {
         switch (policy) {
-            case LaunchPolicy::Async: {
+            case LaunchPolicy::Async:
+            case LaunchPolicy::Parallel: {
                 std::unique_lock<std::mutex> lock{ m_mutex };
                 return random(min, max);
             }
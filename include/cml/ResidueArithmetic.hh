@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/multiprecision/integer.hpp>
+
+#include "LimbArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Sliding window width for an exponent of the given length
+ * \param expBits Exponent bit length
+ * \return 1 for short exponents, which are faster with plain binary exponentiation
+ */
+inline Uint32 windowBitsForExponent(Uint32 expBits)
+{
+    if (expBits > 671)
+        return 6;
+    if (expBits > 239)
+        return 5;
+    if (expBits > 79)
+        return 4;
+    if (expBits > 23)
+        return 3;
+    return 1;
+}
+
+namespace detail {
+
+/**
+ * \brief Buffers of one exponentiation, reused by the next one to keep it off the heap
+ */
+template <typename Residue>
+struct PowerScratch {
+    std::vector<Residue> oddPowers{};
+    Residue squared{};
+    Residue result{};
+    Residue buffer{};
+};
+
+/**
+ * \brief Left-to-right binary exponentiation over a residue context, result goes to scratch.result
+ */
+template <class Context, typename ExpType>
+void binaryPower(const Context& context,
+                 const typename Context::Residue& base,
+                 const ExpType& exp,
+                 PowerScratch<typename Context::Residue>& scratch)
+{
+    auto& result = scratch.result;
+    auto& buffer = scratch.buffer;
+
+    const Uint32 expBits = bitLength(exp);
+    if (expBits == 0) {
+        result = context.one();
+        return;
+    }
+
+    result = base;
+    for (Uint32 i = expBits - 1; i-- > 0;) {
+        context.multiply(buffer, result, result);
+        std::swap(result, buffer);
+
+        if (boost::multiprecision::bit_test(exp, i)) {
+            context.multiply(buffer, result, base);
+            std::swap(result, buffer);
+        }
+    }
+}
+
+/**
+ * \brief Left-to-right binary exponentiation over a residue context
+ * \tparam Context Provides Residue, one() and multiply(result, a, b) with result not aliasing a or b
+ * \param base Residue to raise
+ * \param exp Non-negative exponent
+ * \return base^exp as a residue of the same context
+ */
+template <class Context, typename ExpType>
+typename Context::Residue binaryPower(const Context& context, const typename Context::Residue& base, const ExpType& exp)
+{
+    PowerScratch<typename Context::Residue> scratch{};
+    binaryPower(context, base, exp, scratch);
+    return std::move(scratch.result);
+}
+
+/**
+ * \brief Left-to-right sliding window exponentiation over a residue context, result goes to scratch.result
+ *
+ * Precomputes base^1, base^3, ..., base^(2^windowBits - 1), then consumes the exponent in windows
+ * that start and end with a set bit: one multiplication per window instead of one per set bit.
+ */
+template <class Context, typename ExpType>
+void slidingWindowPower(const Context& context,
+                        const typename Context::Residue& base,
+                        const ExpType& exp,
+                        Uint32 windowBits,
+                        PowerScratch<typename Context::Residue>& scratch)
+{
+    using boost::multiprecision::bit_test;
+
+    auto& result = scratch.result;
+    auto& buffer = scratch.buffer;
+
+    const Uint32 expBits = bitLength(exp);
+    if (expBits == 0) {
+        result = context.one();
+        return;
+    }
+
+    // oddPowers[i] = base^(2i + 1)
+    auto& oddPowers = scratch.oddPowers;
+    oddPowers.resize(std::size_t{ 1 } << (windowBits - 1));
+    oddPowers[0] = base;
+    context.multiply(scratch.squared, base, base);
+    for (std::size_t i = 1; i < oddPowers.size(); ++i) {
+        context.multiply(oddPowers[i], oddPowers[i - 1], scratch.squared);
+    }
+
+    bool started = false;
+
+    for (Int64 i = static_cast<Int64>(expBits) - 1; i >= 0;) {
+        if (!bit_test(exp, static_cast<unsigned>(i))) {
+            context.multiply(buffer, result, result);
+            std::swap(result, buffer);
+            --i;
+            continue;
+        }
+
+        // Longest window [low, i] not wider than windowBits that ends with a set bit
+        Int64 low = std::max<Int64>(i - static_cast<Int64>(windowBits) + 1, 0);
+        while (!bit_test(exp, static_cast<unsigned>(low))) {
+            ++low;
+        }
+
+        std::size_t window = 0;
+        for (Int64 bit = i; bit >= low; --bit) {
+            window = (window << 1) | (bit_test(exp, static_cast<unsigned>(bit)) ? 1 : 0);
+        }
+
+        if (started) {
+            for (Int64 bit = i; bit >= low; --bit) {
+                context.multiply(buffer, result, result);
+                std::swap(result, buffer);
+            }
+            context.multiply(buffer, result, oddPowers[window >> 1]);
+            std::swap(result, buffer);
+        }
+        else {
+            result  = oddPowers[window >> 1];
+            started = true;
+        }
+
+        i = low - 1;
+    }
+}
+
+/**
+ * \brief Left-to-right sliding window exponentiation over a residue context
+ */
+template <class Context, typename ExpType>
+typename Context::Residue slidingWindowPower(const Context& context,
+                                             const typename Context::Residue& base,
+                                             const ExpType& exp,
+                                             Uint32 windowBits)
+{
+    PowerScratch<typename Context::Residue> scratch{};
+    slidingWindowPower(context, base, exp, windowBits, scratch);
+    return std::move(scratch.result);
+}
+
+/**
+ * \brief Product of bases[i]^exps[i] over a residue context with interleaved sliding windows
+ *
+ * Every base gets its own table of odd powers and window width, the squarings are shared: the
+ * product costs max(exps bit length) squarings instead of one chain of squarings per base.
+ */
+template <class Context, typename ExpType>
+typename Context::Residue multiPower(const Context& context,
+                                     const std::vector<typename Context::Residue>& bases,
+                                     const std::vector<ExpType>& exps)
+{
+    using Residue = typename Context::Residue;
+    using boost::multiprecision::bit_test;
+
+    struct Window {
+        Int64 low         = -1; // bit where the pending window ends, -1 if there is none
+        std::size_t value = 0;
+    };
+
+    const std::size_t count = bases.size();
+
+    Uint32 maxBits = 0;
+    std::vector<Uint32> windowBits(count);
+    std::vector<std::vector<Residue>> oddPowers(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const Uint32 expBits = bitLength(exps[i]);
+        maxBits              = std::max(maxBits, expBits);
+        windowBits[i]        = std::max<Uint32>(windowBitsForExponent(expBits), 1);
+
+        // oddPowers[i][j] = bases[i]^(2j + 1)
+        oddPowers[i].resize(std::size_t{ 1 } << (windowBits[i] - 1));
+        oddPowers[i][0] = bases[i];
+        if (oddPowers[i].size() > 1) {
+            const Residue squared = context.multiply(bases[i], bases[i]);
+            for (std::size_t j = 1; j < oddPowers[i].size(); ++j) {
+                context.multiply(oddPowers[i][j], oddPowers[i][j - 1], squared);
+            }
+        }
+    }
+
+    if (maxBits == 0)
+        return context.one();
+
+    std::vector<Window> windows(count);
+    Residue result{};
+    Residue buffer{};
+    bool started = false;
+
+    for (Int64 position = static_cast<Int64>(maxBits) - 1; position >= 0; --position) {
+        if (started) {
+            context.multiply(buffer, result, result);
+            std::swap(result, buffer);
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            Window& window = windows[i];
+
+            if (window.low < 0 && bit_test(exps[i], static_cast<unsigned>(position))) {
+                // Open the longest window [low, position] that ends with a set bit
+                window.low = std::max<Int64>(position - static_cast<Int64>(windowBits[i]) + 1, 0);
+                while (!bit_test(exps[i], static_cast<unsigned>(window.low))) {
+                    ++window.low;
+                }
+
+                window.value = 0;
+                for (Int64 bit = position; bit >= window.low; --bit) {
+                    window.value = (window.value << 1) | (bit_test(exps[i], static_cast<unsigned>(bit)) ? 1 : 0);
+                }
+            }
+
+            // The window's product is multiplied in at its lowest bit, later squarings shift it into place
+            if (window.low == position) {
+                const Residue& factor = oddPowers[i][window.value >> 1];
+                if (started) {
+                    context.multiply(buffer, result, factor);
+                    std::swap(result, buffer);
+                }
+                else {
+                    result  = factor;
+                    started = true;
+                }
+                window.low = -1;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * \brief Exponentiation over a residue context into scratch.result, window width by windowBitsForExponent
+ */
+template <class Context, typename ExpType>
+void power(const Context& context,
+           const typename Context::Residue& base,
+           const ExpType& exp,
+           PowerScratch<typename Context::Residue>& scratch)
+{
+    const Uint32 windowBits = windowBitsForExponent(bitLength(exp));
+    if (windowBits == 1)
+        binaryPower(context, base, exp, scratch);
+    else
+        slidingWindowPower(context, base, exp, windowBits, scratch);
+}
+
+/**
+ * \brief Exponentiation over a residue context with the window width picked by windowBitsForExponent
+ */
+template <class Context, typename ExpType>
+typename Context::Residue power(const Context& context, const typename Context::Residue& base, const ExpType& exp)
+{
+    const Uint32 windowBits = windowBitsForExponent(bitLength(exp));
+    if (windowBits == 1)
+        return binaryPower(context, base, exp);
+    return slidingWindowPower(context, base, exp, windowBits);
+}
+
+/**
+ * \brief Sums, differences and halves of the residues of one context
+ *
+ * Residues of every context are numbers below the modulus, and the Montgomery form is linear, so these are
+ * the same operations on the residues as on the numbers they stand for.
+ */
+template <class Context>
+class ResidueAddition {
+public:
+    using Residue = typename Context::Residue;
+
+    explicit ResidueAddition(const Context& context);
+
+    // result may alias a or b in all of them
+    void add(Residue& result, const Residue& a, const Residue& b) const;
+    void subtract(Residue& result, const Residue& a, const Residue& b) const;
+
+    // result = a / 2, for an odd modulus
+    void halve(Residue& result, const Residue& a) const;
+
+    bool isZero(const Residue& a) const;
+
+private:
+    static constexpr bool isLimbs = std::is_same<Residue, std::vector<Limb>>::value;
+
+    Residue m_modulus{};
+};
+
+template <class Context>
+ResidueAddition<Context>::ResidueAddition(const Context& context)
+{
+    if constexpr (isLimbs) {
+        m_modulus.resize(context.limbCount());
+        exportLimbs(context.modulus(), m_modulus.data(), m_modulus.size());
+    }
+    else {
+        m_modulus = static_cast<Residue>(context.modulus());
+    }
+}
+
+template <class Context>
+void ResidueAddition<Context>::add(Residue& result, const Residue& a, const Residue& b) const
+{
+    if constexpr (isLimbs) {
+        const std::size_t count = m_modulus.size();
+        result.resize(count);
+
+        const Limb carry = addLimbs(result.data(), a.data(), b.data(), count);
+        if (carry != 0 || compareLimbs(result.data(), m_modulus.data(), count) >= 0)
+            subtractLimbs(result.data(), result.data(), m_modulus.data(), count);
+    }
+    else {
+        // The sum may not fit a word modulus
+        const Residue complement = m_modulus - b;
+        result                   = a >= complement ? Residue{ a - complement } : Residue{ a + b };
+    }
+}
+
+template <class Context>
+void ResidueAddition<Context>::subtract(Residue& result, const Residue& a, const Residue& b) const
+{
+    if constexpr (isLimbs) {
+        const std::size_t count = m_modulus.size();
+        result.resize(count);
+
+        if (subtractLimbs(result.data(), a.data(), b.data(), count) != 0)
+            addLimbs(result.data(), result.data(), m_modulus.data(), count);
+    }
+    else {
+        result = a >= b ? Residue{ a - b } : Residue{ a + (m_modulus - b) };
+    }
+}
+
+template <class Context>
+void ResidueAddition<Context>::halve(Residue& result, const Residue& a) const
+{
+    if constexpr (isLimbs) {
+        const std::size_t count = m_modulus.size();
+        result.resize(count);
+
+        // An odd residue plus the odd modulus is even, the carry becomes the top bit
+        Limb carry = 0;
+        if ((a[0] & 1) != 0)
+            carry = addLimbs(result.data(), a.data(), m_modulus.data(), count);
+        else
+            std::copy(a.begin(), a.end(), result.begin());
+
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            result[i] = (result[i] >> 1) | (result[i + 1] << (limbBits - 1));
+        }
+        result[count - 1] = (result[count - 1] >> 1) | (carry << (limbBits - 1));
+    }
+    else {
+        // (a + modulus) / 2 without the sum, which may not fit
+        const bool odd = (a & 1) != 0;
+        result         = odd ? Residue{ (a >> 1) + (m_modulus >> 1) + 1 } : Residue{ a >> 1 };
+    }
+}
+
+template <class Context>
+bool ResidueAddition<Context>::isZero(const Residue& a) const
+{
+    if constexpr (isLimbs)
+        return std::all_of(a.begin(), a.end(), [](Limb limb) { return limb == 0; });
+    else
+        return a == 0;
+}
+
+} // namespace detail
+} // namespace cml
\ No newline at end of file
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "Algorithms.hh"
+#include "LimbArithmetic.hh"
+#include "ResidueArithmetic.hh"
+#include "Typedefs.hh"
+#include "WordMontgomeryContext.hh"
+
+namespace cml {
+
+/**
+ * \brief Residue number system: arithmetic modulo the product of pairwise coprime odd words, one channel per word
+ *
+ * A residue holds one word per modulus, in the Montgomery form of that channel. Channels never interact:
+ * addition and multiplication are one independent word operation per channel, so big products can be split
+ * across channels, and across threads by channel ranges. Conversions both ways are quadratic in the channel
+ * count but plain word products only: numbers go in as limb sums weighted by R^k mod m_i, and come back by
+ * Garner's mixed-radix conversion with precomputed constants. The tables take 1.5 * channelCount()^2 words.
+ */
+class ResidueNumberSystem {
+public:
+    using Value   = UnboundedInt;
+    using Residue = std::vector<Limb>;
+
+    /**
+     * \param moduli Pairwise coprime odd numbers greater than 1, word primes usually
+     */
+    explicit ResidueNumberSystem(const std::vector<Limb>& moduli);
+
+    // Product of the moduli, residues represent numbers modulo it
+    const Value& modulus() const;
+    const std::vector<Limb>& moduli() const;
+    std::size_t channelCount() const;
+
+    const Residue& one() const;
+    Residue toResidue(const Value& number) const;
+
+    // Number below modulus() the residue stands for
+    Value fromResidue(const Residue& residue) const;
+
+    // Residue of channel, a plain number below moduli()[channel]
+    Limb channelValue(const Residue& residue, std::size_t channel) const;
+
+    /**
+     * \brief result = a + b, channel by channel
+     * \param result May alias \a a or \a b
+     */
+    void add(Residue& result, const Residue& a, const Residue& b) const;
+    void subtract(Residue& result, const Residue& a, const Residue& b) const;
+
+    /**
+     * \brief result = a * b, channel by channel
+     * \param result May alias \a a or \a b
+     */
+    void multiply(Residue& result, const Residue& a, const Residue& b) const;
+    Residue multiply(const Residue& a, const Residue& b) const;
+
+    template <typename ExpType>
+    Residue power(const Residue& base, const ExpType& exp) const;
+
+    template <typename ExpType>
+    Value modexp(const Value& base, const ExpType& exp) const;
+
+private:
+    static Limb add(Limb a, Limb b, Limb modulus);
+    static Limb subtract(Limb a, Limb b, Limb modulus);
+
+    // high * 2^(2 * limbBits) + low modulo channel's modulus, a plain number
+    Limb reduceWide(std::size_t channel, DoubleLimb low, Limb high) const;
+
+    std::vector<Limb> m_moduli{};
+    std::vector<WordMontgomeryContext<Limb>> m_contexts{};
+    Value m_modulus{};
+    Residue m_one{};
+    std::vector<Limb> m_radixSquared{}; // R^2 mod m_i
+    std::vector<Limb> m_radixCubed{}; // R^3 mod m_i
+
+    // R^k mod m_i at i * channelCount() + k, plain
+    std::vector<Limb> m_limbWeights{};
+
+    // (m_0 * ... * m_(i-1))^-1 mod m_i in Montgomery form, a Montgomery product with it is the plain product
+    std::vector<Limb> m_garnerInverses{};
+    // (m_0 * ... * m_(j-1)) mod m_i for j < i at i * (i - 1) / 2 + j, plain
+    std::vector<Limb> m_garnerFactors{};
+};
+
+inline ResidueNumberSystem::ResidueNumberSystem(const std::vector<Limb>& moduli) : m_moduli(moduli), m_modulus(1)
+{
+    if (moduli.empty())
+        throw std::domain_error{ "cml::ResidueNumberSystem::ResidueNumberSystem(moduli): No moduli" };
+
+    const std::size_t count = moduli.size();
+    m_contexts.reserve(count);
+    for (Limb modulus : moduli) {
+        if (modulus < 3 || modulus % 2 == 0)
+            throw std::domain_error{ "cml::ResidueNumberSystem::ResidueNumberSystem(moduli): Moduli must be odd "
+                                     "and greater than 1" };
+        m_contexts.emplace_back(modulus);
+        m_one.push_back(m_contexts.back().one());
+        m_modulus *= modulus;
+    }
+
+    m_limbWeights.resize(count * count);
+    m_garnerInverses.resize(count);
+    m_garnerFactors.resize(count * (count - 1) / 2);
+    for (std::size_t i = 0; i < count; ++i) {
+        const WordMontgomeryContext<Limb>& context = m_contexts[i];
+
+        // A Montgomery product with R^(k + 1) is a product with R^k
+        m_radixSquared.push_back(context.toResidue(m_one[i]));
+        m_radixCubed.push_back(context.toResidue(m_radixSquared[i]));
+
+        Limb weight = 1;
+        for (std::size_t k = 0; k < count; ++k) {
+            m_limbWeights[i * count + k] = weight;
+            weight                       = context.multiply(weight, m_radixSquared[i]);
+        }
+
+        // prefix = m_0 * ... * m_(j-1) mod m_i
+        Limb prefix = 1;
+        for (std::size_t j = 0; j < i; ++j) {
+            m_garnerFactors[i * (i - 1) / 2 + j] = prefix;
+            prefix = static_cast<Limb>(static_cast<DoubleLimb>(prefix) * moduli[j] % moduli[i]);
+        }
+
+        if (gcd(prefix, moduli[i]) != 1)
+            throw std::domain_error{ "cml::ResidueNumberSystem::ResidueNumberSystem(moduli): Moduli must be "
+                                     "pairwise coprime" };
+        m_garnerInverses[i] = context.toResidue(invmod(prefix, moduli[i]));
+    }
+}
+
+inline const ResidueNumberSystem::Value& ResidueNumberSystem::modulus() const
+{
+    return m_modulus;
+}
+
+inline const std::vector<Limb>& ResidueNumberSystem::moduli() const
+{
+    return m_moduli;
+}
+
+inline std::size_t ResidueNumberSystem::channelCount() const
+{
+    return m_moduli.size();
+}
+
+inline const ResidueNumberSystem::Residue& ResidueNumberSystem::one() const
+{
+    return m_one;
+}
+
+inline ResidueNumberSystem::Residue ResidueNumberSystem::toResidue(const Value& number) const
+{
+    const std::size_t count = channelCount();
+
+    // The weights cover channelCount() limbs, longer numbers are cut down to the modulus first
+    Value magnitude = abs(number);
+    if (limbLength(magnitude) > count)
+        magnitude %= m_modulus;
+
+    std::vector<Limb> limbs(limbLength(magnitude));
+    detail::exportLimbs(magnitude, limbs.data(), limbs.size());
+
+    Residue residue(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Limb* weights = m_limbWeights.data() + i * count;
+
+        // At most channelCount() products below 2^128, the sum fits three limbs
+        DoubleLimb sum = 0;
+        Limb high      = 0;
+        for (std::size_t k = 0; k < limbs.size(); ++k) {
+            const DoubleLimb product = static_cast<DoubleLimb>(limbs[k]) * weights[k];
+            sum += product;
+            high += sum < product ? 1 : 0;
+        }
+
+        const Limb value = m_contexts[i].multiply(reduceWide(i, sum, high), m_radixSquared[i]);
+        residue[i]       = number < 0 ? subtract(0, value, m_moduli[i]) : value;
+    }
+
+    return residue;
+}
+
+inline ResidueNumberSystem::Value ResidueNumberSystem::fromResidue(const Residue& residue) const
+{
+    const std::size_t count = channelCount();
+
+    // Mixed-radix digits: number = t_0 + t_1 * m_0 + t_2 * m_0 * m_1 + ..., digit i removes from channel i
+    // the part of the number the lower digits already fix
+    std::vector<Limb> digits(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Limb* factors = m_garnerFactors.data() + i * (i - 1) / 2;
+
+        DoubleLimb sum = 0;
+        Limb high      = 0;
+        for (std::size_t j = 0; j < i; ++j) {
+            const DoubleLimb product = static_cast<DoubleLimb>(digits[j]) * factors[j];
+            sum += product;
+            high += sum < product ? 1 : 0;
+        }
+
+        const Limb known = reduceWide(i, sum, high);
+        digits[i] = m_contexts[i].multiply(subtract(channelValue(residue, i), known, m_moduli[i]), m_garnerInverses[i]);
+    }
+
+    // Horner over the digits from the top, one limb multiply-add per limb of the partial number
+    std::vector<Limb> limbs(count, 0);
+    std::size_t length = 1;
+    limbs[0]           = digits[count - 1];
+    for (std::size_t j = count - 1; j-- > 0;) {
+        Limb carry = digits[j];
+        for (std::size_t k = 0; k < length; ++k) {
+            const DoubleLimb product = static_cast<DoubleLimb>(limbs[k]) * m_moduli[j] + carry;
+            limbs[k]                 = static_cast<Limb>(product);
+            carry                    = static_cast<Limb>(product >> limbBits);
+        }
+        if (carry != 0)
+            limbs[length++] = carry;
+    }
+
+    Value result{};
+    detail::importLimbs(result, limbs.data(), length);
+    return result;
+}
+
+inline Limb ResidueNumberSystem::channelValue(const Residue& residue, std::size_t channel) const
+{
+    return m_contexts[channel].multiply(residue[channel], Limb{ 1 });
+}
+
+inline void ResidueNumberSystem::add(Residue& result, const Residue& a, const Residue& b) const
+{
+    result.resize(channelCount());
+    for (std::size_t i = 0; i < channelCount(); ++i) {
+        result[i] = add(a[i], b[i], m_moduli[i]);
+    }
+}
+
+inline void ResidueNumberSystem::subtract(Residue& result, const Residue& a, const Residue& b) const
+{
+    result.resize(channelCount());
+    for (std::size_t i = 0; i < channelCount(); ++i) {
+        result[i] = subtract(a[i], b[i], m_moduli[i]);
+    }
+}
+
+inline void ResidueNumberSystem::multiply(Residue& result, const Residue& a, const Residue& b) const
+{
+    result.resize(channelCount());
+    for (std::size_t i = 0; i < channelCount(); ++i) {
+        result[i] = m_contexts[i].multiply(a[i], b[i]);
+    }
+}
+
+inline ResidueNumberSystem::Residue ResidueNumberSystem::multiply(const Residue& a, const Residue& b) const
+{
+    Residue result{};
+    multiply(result, a, b);
+    return result;
+}
+
+template <typename ExpType>
+ResidueNumberSystem::Residue ResidueNumberSystem::power(const Residue& base, const ExpType& exp) const
+{
+    return detail::power(*this, base, exp);
+}
+
+template <typename ExpType>
+ResidueNumberSystem::Value ResidueNumberSystem::modexp(const Value& base, const ExpType& exp) const
+{
+    return fromResidue(power(toResidue(base), exp));
+}
+
+inline Limb ResidueNumberSystem::add(Limb a, Limb b, Limb modulus)
+{
+    // Moduli may take the whole word, a + b could overflow
+    const Limb complement = modulus - b;
+    return a >= complement ? a - complement : a + b;
+}
+
+inline Limb ResidueNumberSystem::subtract(Limb a, Limb b, Limb modulus)
+{
+    return a - b + (a < b ? modulus : Limb{ 0 });
+}
+
+inline Limb ResidueNumberSystem::reduceWide(std::size_t channel, DoubleLimb low, Limb high) const
+{
+    // Montgomery products with R, R^2 and R^3 scale the limbs by 1, R and R^2, every limb is below 2^64
+    // and so any of them is fine as a factor
+    const WordMontgomeryContext<Limb>& context = m_contexts[channel];
+    const Limb modulus                         = m_moduli[channel];
+
+    const Limb lowPart    = context.multiply(static_cast<Limb>(low), m_one[channel]);
+    const Limb middlePart = context.multiply(static_cast<Limb>(low >> limbBits), m_radixSquared[channel]);
+    const Limb highPart   = context.multiply(high, m_radixCubed[channel]);
+    return add(add(lowPart, middlePart, modulus), highPart, modulus);
+}
+
+} // namespace cml
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Algorithms.hh"
 #include "IsPrimeGenerator.hh"
 #include "Typedefs.hh"
+#include "Workspace.hh"
 
 namespace cml {
 
@@ -54,8 +55,18 @@ RsaProtocol<PrimeGeneratorType>::RsaProtocol(const PrimeGenerator& primeGenerato
 template <typename PrimeGeneratorType>
 void RsaProtocol<PrimeGeneratorType>::generate()
 {
-    UnboundedInt p{ primeGenerator() };
-    UnboundedInt q{ primeGenerator() };
+    // Mersenne prime number
+    publicKey.e = 65537;
+
+    // e must be invertible modulo phi: as e is prime, neither p nor q may be 1 modulo e. phi is the totient
+    // only for distinct primes, and small bitnesses draw the same one twice now and then: q is redrawn then
+    UnboundedInt p{}, q{};
+    do {
+        p = UnboundedInt{ primeGenerator() };
+    } while (p % publicKey.e == 1);
+    do {
+        q = UnboundedInt{ primeGenerator() };
+    } while (q == p || q % publicKey.e == 1);
 
     // Compute phi
     UnboundedInt phi = (p - 1) * (q - 1);
@@ -65,9 +76,6 @@ void RsaProtocol<PrimeGeneratorType>::generate()
     publicKey.n    = n;
     privateKey.n   = n;
 
-    // Mersenne prime number
-    publicKey.e = 65537;
-
     // Compute 'd'
     privateKey.d = invmod(publicKey.e, phi);
 }
@@ -85,8 +93,13 @@ std::vector<UnboundedInt> RsaProtocol<PrimeGeneratorType>::encrypt(const std::ve
     std::vector<UnboundedInt> result{};
     result.resize(source.size());
 
+    // All blocks share the modulus and the buffers of one workspace
+    Workspace<UnboundedInt> workspace{};
+    UnboundedInt block{};
+
     for (std::size_t i = 0; i < source.size(); ++i) {
-        result[i] = encrypt(source[i], anotherPublicKey);
+        block = source[i];
+        modexp(result[i], block, anotherPublicKey.e, anotherPublicKey.n, workspace);
     }
 
     return result;
@@ -104,8 +117,13 @@ std::vector<Uint64> RsaProtocol<PrimeGeneratorType>::decrypt(const std::vector<U
     std::vector<Uint64> result{};
     result.resize(source.size());
 
+    // All blocks share the modulus and the buffers of one workspace
+    Workspace<UnboundedInt> workspace{};
+    UnboundedInt block{};
+
     for (std::size_t i = 0; i < source.size(); ++i) {
-        result[i] = decrypt(source[i]);
+        modexp(block, source[i], privateKey.d, privateKey.n, workspace);
+        result[i] = static_cast<Uint64>(block);
     }
 
     return result;
@@ -1,16 +1,20 @@
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <future>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <thread>
 
 #include "Algorithms.hh"
 #include "ExtendedContainer.hh"
+#include "FixedBaseExponentiator.hh"
 #include "IsPrimeGenerator.hh"
+#include "LaunchPolicy.hh"
 #include "Typedefs.hh"
 #include "picosha2.h"
 
@@ -25,6 +29,14 @@ Uint256 srp6Hash(Args&&... args)
     return Uint256{ addBasePrefix(hash) };
 }
 
+// For the prime N, base^exp mod N doesn't change when exp is reduced into [1, N - 1]
+inline UnboundedInt srp6ReduceExponent(const UnboundedInt& exp, const UnboundedInt& N)
+{
+    if (exp == 0)
+        return 0;
+    return (exp - 1) % (N - 1) + 1;
+}
+
 /* ================================================================================= */
 /* =============================== Srp6SecurityBase ================================ */
 /* ================================================================================= */
@@ -33,28 +45,53 @@ template <typename ValueType>
 struct Srp6SecurityBase {
     using SafePrime          = ValueType;
     using MultGroupGenerator = ValueType;
+    using Exponentiator      = FixedBaseExponentiator<ValueType>;
 
+    /**
+     * \brief N from the safe prime generator, g its smallest primitive root
+     * \param policy Launch policy of the safe prime generator and of the primality test on N
+     */
     template <class SafePrimeGeneratorType, class RandomGeneratorType>
-    static Srp6SecurityBase create(SafePrimeGeneratorType& safePrimeGenerator, RandomGeneratorType& randomGenerator);
+    static Srp6SecurityBase create(SafePrimeGeneratorType& safePrimeGenerator,
+                                   RandomGeneratorType& randomGenerator,
+                                   LaunchPolicy policy = LaunchPolicy::Sync);
 
     template <class SafePrimeGeneratorType, class RandomGeneratorType>
-    static Srp6SecurityBase create();
+    static Srp6SecurityBase create(LaunchPolicy policy = LaunchPolicy::Sync);
 
+    /**
+     * \brief As create, with k = H(N, g) of SRP-6a
+     */
     template <class SafePrimeGeneratorType, class RandomGeneratorType>
-    static Srp6SecurityBase createA(SafePrimeGeneratorType& safePrimeGenerator, RandomGeneratorType& randomGenerator);
+    static Srp6SecurityBase createA(SafePrimeGeneratorType& safePrimeGenerator,
+                                    RandomGeneratorType& randomGenerator,
+                                    LaunchPolicy policy = LaunchPolicy::Sync);
 
     template <class SafePrimeGeneratorType, class RandomGeneratorType>
-    static Srp6SecurityBase createA();
+    static Srp6SecurityBase createA(LaunchPolicy policy = LaunchPolicy::Sync);
+
+    /**
+     * \brief Builds the fixed-base table for g, copies of this security base share it
+     */
+    void precompute();
+
+    /**
+     * \brief g^exp mod N, through the precomputed table if it was built for the current g and N
+     */
+    template <typename ExpType>
+    SafePrime generatorPower(const ExpType& exp) const;
 
     SafePrime N{}; // safe prime
     MultGroupGenerator g{}; // generator of the multiplicative group
     Uint256 k{};
+    std::shared_ptr<const Exponentiator> exponentiator{}; // optional, see precompute()
 };
 
 template <typename ValueType>
 template <class SafePrimeGeneratorType, class RandomGeneratorType>
 Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::create(SafePrimeGeneratorType& safePrimeGenerator,
-                                                                RandomGeneratorType& randomGenerator)
+                                                                RandomGeneratorType& randomGenerator,
+                                                                LaunchPolicy policy)
 {
     static_assert(
         IsPrimeGenerator<SafePrimeGeneratorType>::value,
@@ -63,8 +100,8 @@ Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::create(SafePrimeGenerat
 
     Srp6SecurityBase securityBase{};
 
-    securityBase.N = static_cast<SafePrime>(safePrimeGenerator());
-    securityBase.g = static_cast<MultGroupGenerator>(primitiveRootModulo(securityBase.N, randomGenerator));
+    securityBase.N = static_cast<SafePrime>(safePrimeGenerator(policy));
+    securityBase.g = static_cast<MultGroupGenerator>(primitiveRootModulo(securityBase.N, randomGenerator, policy));
     securityBase.k = 3;
 
     return securityBase;
@@ -72,24 +109,25 @@ Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::create(SafePrimeGenerat
 
 template <typename ValueType>
 template <class SafePrimeGeneratorType, class RandomGeneratorType>
-Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::create()
+Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::create(LaunchPolicy policy)
 {
     SafePrimeGeneratorType safePrimeGenerator{};
     RandomGeneratorType randomGenerator{};
-    return create(safePrimeGenerator, randomGenerator);
+    return create(safePrimeGenerator, randomGenerator, policy);
 }
 
 template <typename ValueType>
 template <class SafePrimeGeneratorType, class RandomGeneratorType>
 Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::createA(SafePrimeGeneratorType& safePrimeGenerator,
-                                                                 RandomGeneratorType& randomGenerator)
+                                                                 RandomGeneratorType& randomGenerator,
+                                                                 LaunchPolicy policy)
 {
     static_assert(
         IsPrimeGenerator<SafePrimeGeneratorType>::value,
         "Invalid template argument for cml::Srp6SecurityBase::create(...): SafePrimeGeneratorType interface is "
         "not suitable");
 
-    Srp6SecurityBase securityBase = create(safePrimeGenerator);
+    Srp6SecurityBase securityBase = create(safePrimeGenerator, randomGenerator, policy);
 
     securityBase.k = srp6Hash(securityBase.N, securityBase.g);
     return securityBase;
@@ -97,11 +135,31 @@ Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::createA(SafePrimeGenera
 
 template <typename ValueType>
 template <class SafePrimeGeneratorType, class RandomGeneratorType>
-Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::createA()
+Srp6SecurityBase<ValueType> Srp6SecurityBase<ValueType>::createA(LaunchPolicy policy)
 {
     SafePrimeGeneratorType safePrimeGenerator{};
     RandomGeneratorType randomGenerator{};
-    return createA(safePrimeGenerator, randomGenerator);
+    return createA(safePrimeGenerator, randomGenerator, policy);
+}
+
+template <typename ValueType>
+void Srp6SecurityBase<ValueType>::precompute()
+{
+    if (g == 0 || N == 0)
+        throw std::logic_error{ "Security base is not generated" };
+
+    // Exponents are either ephemeral keys below N or 256-bit password hashes
+    exponentiator = std::make_shared<const Exponentiator>(g, N, std::max<Uint32>(bitLength(N), 256));
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename Srp6SecurityBase<ValueType>::SafePrime Srp6SecurityBase<ValueType>::generatorPower(const ExpType& exp) const
+{
+    if (exponentiator && exponentiator->base() == g && exponentiator->context().modulus() == N)
+        return exponentiator->modexp(exp);
+
+    return static_cast<SafePrime>(modexp(UnboundedInt{ g }, UnboundedInt{ exp }, UnboundedInt{ N }));
 }
 
 /* ================================================================================= */
@@ -147,11 +205,7 @@ Srp6ServerData<VerifierType> Srp6ServerData<VerifierType>::create(RandomGenerato
     data.salt = randomString(password.size(), randomGenerator);
     data.x    = srp6Hash(data.salt, password);
 
-    UnboundedInt g = securityBase.g;
-    UnboundedInt x = data.x;
-    UnboundedInt N = securityBase.N;
-
-    data.v = static_cast<Verifier>(modexp(g, x, N));
+    data.v = static_cast<Verifier>(securityBase.generatorPower(data.x));
 
     return data;
 }
@@ -205,10 +259,8 @@ typename Srp6Server<ValueType, RandomGeneratorType>::PublicKey
 
     publicKey.salt = data.salt;
 
-    using ModExpType = UnboundedInt;
-
     UnboundedInt kv  = UnboundedInt{ securityBase.k } * data.v;
-    UnboundedInt gb  = modexp<ModExpType>(securityBase.g, b, securityBase.N);
+    UnboundedInt gb  = securityBase.generatorPower(b);
     UnboundedInt res = kv % securityBase.N + gb;
 
     publicKey.B = static_cast<Value>(res);
@@ -229,11 +281,10 @@ typename Srp6Server<ValueType, RandomGeneratorType>::PrivateKey
     UnboundedInt N = securityBase.N;
     UnboundedInt v = data.v;
 
-    UnboundedInt base    = A * modexp(v, u, N);
-    UnboundedInt exp     = b;
-    UnboundedInt modulus = securityBase.N;
+    // S = (A * v^u)^b = A^b * v^(u * b), both powers share one chain of squarings
+    UnboundedInt exp = b;
 
-    UnboundedInt S = modexp(base, exp, modulus);
+    UnboundedInt S = multiExp<UnboundedInt>({ A, v }, { exp, srp6ReduceExponent(u * exp, N) }, N);
 
     PrivateKey privateKey{};
     privateKey.K = srp6Hash(S);
@@ -302,8 +353,7 @@ typename Srp6Client<ValueType, RandomGeneratorType>::PublicKey
 
     publicKey.identifier = identifier;
 
-    using ModExpType = UnboundedInt;
-    publicKey.A      = static_cast<Value>(modexp<ModExpType>(securityBase.g, a, securityBase.N));
+    publicKey.A = securityBase.generatorPower(a);
 
     return publicKey;
 }
@@ -319,20 +369,21 @@ typename Srp6Client<ValueType, RandomGeneratorType>::PrivateKey
     UnboundedInt x = srp6Hash(serverPublicKey.salt, password);
     UnboundedInt u = srp6Hash(clientPublicKey.A, serverPublicKey.B);
 
-    UnboundedInt N = securityBase.N;
-    UnboundedInt g = securityBase.g;
-    UnboundedInt k = securityBase.k;
-    UnboundedInt B = serverPublicKey.B;
+    UnboundedInt N  = securityBase.N;
+    UnboundedInt gx = securityBase.generatorPower(x);
+    UnboundedInt k  = securityBase.k;
+    UnboundedInt B  = serverPublicKey.B;
 
-    UnboundedInt base    = B - (k * modexp(g, x, N)) % N;
-    UnboundedInt exp     = u * x + a;
-    UnboundedInt modulus = securityBase.N;
+    // The base depends on g^x, so the two powers can't share squarings. Reducing u * x + a keeps the
+    // exponent no longer than N instead
+    UnboundedInt base = B - (k * gx) % N;
+    UnboundedInt exp  = srp6ReduceExponent(u * x + a, N);
 
-    UnboundedInt S = modexp(base, exp, modulus);
+    UnboundedInt S = modexp(base, exp, N);
 
     PrivateKey privateKey{};
     privateKey.K = srp6Hash(S);
 
     return privateKey;
 }
-} // namespace cml
+} // namespace cml
\ No newline at end of file
@@ -26,4 +26,7 @@ using Int1014 = boost::multiprecision::int1024_t;
 
 using UnboundedInt = boost::multiprecision::cpp_int;
 
+using Limb       = boost::multiprecision::limb_type;
+using DoubleLimb = boost::multiprecision::double_limb_type;
+
 } // namespace cml
\ No newline at end of file
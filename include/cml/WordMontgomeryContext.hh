@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "LimbArithmetic.hh"
+#include "ResidueArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Residue ring modulo an odd number that fits a single limb, in Montgomery form
+ * \tparam ValueType Built-in unsigned type of the modulus and of converted numbers
+ *
+ * Same reduction as MontgomeryContext, but residues are plain words and a product is three word
+ * multiplications with the double-limb intermediate kept in registers, without any division.
+ */
+template <typename ValueType>
+class WordMontgomeryContext {
+    static_assert(IsSingleLimb<ValueType>::value,
+                  "Invalid template argument for cml::WordMontgomeryContext: ValueType doesn't fit a limb");
+
+public:
+    using Value   = ValueType;
+    using Residue = Limb;
+
+    explicit WordMontgomeryContext(const Value& modulus);
+
+    const Value& modulus() const;
+    std::size_t limbCount() const;
+
+    const Residue& one() const;
+    Residue toResidue(const Value& number) const;
+    Value fromResidue(const Residue& residue) const;
+
+    void multiply(Residue& result, const Residue& a, const Residue& b) const;
+    Residue multiply(const Residue& a, const Residue& b) const;
+
+    template <typename ExpType>
+    Residue power(const Residue& base, const ExpType& exp) const;
+
+    template <typename ExpType>
+    Value modexp(const Value& base, const ExpType& exp) const;
+
+private:
+    Value m_modulus{};
+    Limb m_modulusLimb{ 0 };
+    Limb m_inverse{ 0 }; // modulus^(-1) mod 2^limbBits
+    Residue m_one{ 0 }; // R mod modulus
+    Residue m_radixSquared{ 0 }; // R^2 mod modulus
+};
+
+template <typename ValueType>
+WordMontgomeryContext<ValueType>::WordMontgomeryContext(const Value& modulus) :
+    m_modulus(modulus),
+    m_modulusLimb(modulus)
+{
+    if (modulus < 3 || modulus % 2 == 0)
+        throw std::domain_error{ "cml::WordMontgomeryContext::WordMontgomeryContext(modulus): Modulus must be odd "
+                                 "and greater than 1" };
+
+    Limb inverse = m_modulusLimb;
+    for (Uint32 bits = 3; bits < limbBits; bits *= 2) {
+        inverse *= Limb{ 2 } - m_modulusLimb * inverse;
+    }
+    m_inverse = inverse;
+
+    // 2^limbBits - modulus is congruent to R
+    m_one          = (Limb{ 0 } - m_modulusLimb) % m_modulusLimb;
+    m_radixSquared = static_cast<Limb>(static_cast<DoubleLimb>(m_one) * m_one % m_modulusLimb);
+}
+
+template <typename ValueType>
+const typename WordMontgomeryContext<ValueType>::Value& WordMontgomeryContext<ValueType>::modulus() const
+{
+    return m_modulus;
+}
+
+template <typename ValueType>
+std::size_t WordMontgomeryContext<ValueType>::limbCount() const
+{
+    return 1;
+}
+
+template <typename ValueType>
+const typename WordMontgomeryContext<ValueType>::Residue& WordMontgomeryContext<ValueType>::one() const
+{
+    return m_one;
+}
+
+template <typename ValueType>
+typename WordMontgomeryContext<ValueType>::Residue WordMontgomeryContext<ValueType>::toResidue(
+    const Value& number) const
+{
+    return multiply(static_cast<Limb>(number % m_modulus), m_radixSquared);
+}
+
+template <typename ValueType>
+typename WordMontgomeryContext<ValueType>::Value WordMontgomeryContext<ValueType>::fromResidue(
+    const Residue& residue) const
+{
+    return static_cast<Value>(multiply(residue, Limb{ 1 }));
+}
+
+template <typename ValueType>
+void WordMontgomeryContext<ValueType>::multiply(Residue& result, const Residue& a, const Residue& b) const
+{
+    result = multiply(a, b);
+}
+
+template <typename ValueType>
+typename WordMontgomeryContext<ValueType>::Residue WordMontgomeryContext<ValueType>::multiply(const Residue& a,
+                                                                                             const Residue& b) const
+{
+    // (a * b - q * modulus) / 2^limbBits, q makes the low halves equal, so only the high halves are
+    // subtracted and the difference in (-modulus, modulus) is corrected without a data-dependent branch
+    const DoubleLimb product = static_cast<DoubleLimb>(a) * b;
+    const Limb q             = static_cast<Limb>(product) * m_inverse;
+    const DoubleLimb reduced = static_cast<DoubleLimb>(q) * m_modulusLimb;
+
+    const Limb productHigh = static_cast<Limb>(product >> limbBits);
+    const Limb reducedHigh = static_cast<Limb>(reduced >> limbBits);
+    const Limb difference  = productHigh - reducedHigh;
+    return difference + (productHigh < reducedHigh ? m_modulusLimb : Limb{ 0 });
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename WordMontgomeryContext<ValueType>::Residue WordMontgomeryContext<ValueType>::power(const Residue& base,
+                                                                                          const ExpType& exp) const
+{
+    return detail::power(*this, base, exp);
+}
+
+template <typename ValueType>
+template <typename ExpType>
+typename WordMontgomeryContext<ValueType>::Value WordMontgomeryContext<ValueType>::modexp(const Value& base,
+                                                                                         const ExpType& exp) const
+{
+    return fromResidue(power(toResidue(base), exp));
+}
+
+} // namespace cml
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <optional>
+
+#include <boost/multiprecision/integer.hpp>
+
+#include "DivisionContext.hh"
+#include "LimbArithmetic.hh"
+#include "MontgomeryContext.hh"
+#include "ResidueArithmetic.hh"
+#include "Typedefs.hh"
+
+namespace cml {
+
+/**
+ * \brief Buffers reused by the allocation-free modexp and modmul overloads
+ * \tparam ValueType Integer type of the modulus and of the operands
+ *
+ * Keeps the Montgomery form of the last odd modulus together with every limb buffer of the exponentiation.
+ * Once a call has grown them, further calls with the same modulus and operands below it don't touch the
+ * heap. Another modulus costs one context setup, an even one falls back to plain division. A workspace
+ * serves one thread at a time.
+ */
+template <typename ValueType>
+class Workspace {
+public:
+    using Value   = ValueType;
+    using Context = MontgomeryContext<Value>;
+    using Residue = typename Context::Residue;
+
+    /**
+     * \brief result = base^exp mod modulus
+     * \param result May alias \a base or \a exp
+     */
+    template <typename ExpType>
+    void modexp(Value& result, const Value& base, const ExpType& exp, const Value& modulus);
+
+    /**
+     * \brief result = a * b mod modulus
+     * \param result May alias \a a or \a b
+     */
+    void modmul(Value& result, const Value& a, const Value& b, const Value& modulus);
+
+private:
+    // Context of modulus, rebuilt only when it differs from the cached one. Null for even moduli
+    const Context* context(const Value& modulus);
+
+    std::optional<Context> m_context{};
+    detail::PowerScratch<Residue> m_power{};
+    Residue m_base{};
+    Residue m_factor{};
+    Residue m_scratch{};
+};
+
+template <typename ValueType>
+template <typename ExpType>
+void Workspace<ValueType>::modexp(Value& result, const Value& base, const ExpType& exp, const Value& modulus)
+{
+    if (modulus == 1) {
+        result = 0;
+        return;
+    }
+
+    const Context* montgomery = context(modulus);
+    if (montgomery == nullptr) {
+        result = DivisionContext<Value>{ modulus }.modexp(base, exp);
+        return;
+    }
+
+    montgomery->toResidue(m_base, base, m_scratch);
+    detail::power(*montgomery, m_base, exp, m_power);
+    montgomery->fromResidue(result, m_power.result, m_scratch);
+}
+
+template <typename ValueType>
+void Workspace<ValueType>::modmul(Value& result, const Value& a, const Value& b, const Value& modulus)
+{
+    if (modulus == 1) {
+        result = 0;
+        return;
+    }
+
+    const Context* montgomery = context(modulus);
+    if (montgomery == nullptr) {
+        DivisionContext<Value> division{ modulus };
+        result = division.fromResidue(division.multiply(division.toResidue(a), division.toResidue(b)));
+        return;
+    }
+
+    // Montgomery product of a * R and plain b is plain a * b, one conversion is enough
+    montgomery->toResidue(m_base, a, m_scratch);
+
+    m_factor.resize(montgomery->limbCount());
+    if (b < modulus)
+        detail::exportLimbs(b, m_factor.data(), m_factor.size());
+    else
+        detail::exportLimbs(static_cast<Value>(b % modulus), m_factor.data(), m_factor.size());
+
+    montgomery->multiply(m_scratch, m_base, m_factor);
+    detail::importLimbs(result, m_scratch.data(), m_scratch.size());
+}
+
+template <typename ValueType>
+const typename Workspace<ValueType>::Context* Workspace<ValueType>::context(const Value& modulus)
+{
+    // Not modulus % 2, which allocates a multiprecision temporary
+    if (!boost::multiprecision::bit_test(modulus, 0))
+        return nullptr;
+
+    if (!m_context || m_context->modulus() != modulus)
+        m_context.emplace(modulus);
+
+    return &*m_context;
+}
+
+} // namespace cml
\ No newline at end of file
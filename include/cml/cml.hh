@@ -1,15 +1,39 @@
 #pragma once
 
 #include "Algorithms.hh"
+#include "BailliePswTest.hh"
+#include "BarrettContext.hh"
+#include "BatchPrimality.hh"
+#include "BatchTrialDivision.hh"
+#include "BoundedMpmcQueue.hh"
+#include "CandidateSearch.hh"
+#include "ConstexprArithmetic.hh"
 #include "ContainerByBitness.hh"
+#include "DeterministicPrimality.hh"
 #include "DiffieHellmanProtocol.hh"
+#include "DivisionContext.hh"
+#include "FixedBaseExponentiator.hh"
 #include "IsPrimeGenerator.hh"
 #include "IsRandomGenerator.hh"
+#include "LehmerGcd.hh"
+#include "LimbArithmetic.hh"
 #include "MilRabPrimeGenerator.hh"
 #include "MilRabSafePrimeGenerator.hh"
+#include "MillerRabinRounds.hh"
+#include "MontgomeryContext.hh"
 #include "Mt19937RandomGenerator.hh"
+#include "NttMultiplication.hh"
+#include "Parallel.hh"
+#include "PrimalityTestPolicy.hh"
 #include "PrimeGenerator.hh"
+#include "PrimePool.hh"
+#include "PrimeSieve.hh"
+#include "ProductTree.hh"
 #include "RandomGenerator.hh"
+#include "ResidueArithmetic.hh"
+#include "ResidueNumberSystem.hh"
 #include "RsaProtocol.hh"
 #include "Srp6Protocol.hh"
-#include "Typedefs.hh"
\ No newline at end of file
+#include "Typedefs.hh"
+#include "WordMontgomeryContext.hh"
+#include "Workspace.hh"
\ No newline at end of file
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <type_traits>
+
 #include <gtest/gtest.h>
 
 #include <cml/cml.hh>
@@ -594,4 +600,770 @@ TEST(Algorithms, primitiveRootModulo)
     EXPECT_EQ(primitiveRootModulo(9, rnd), 0);
     EXPECT_EQ(primitiveRootModulo(10, rnd), 0);
     EXPECT_EQ(primitiveRootModulo(11, rnd), 2);
+}
+
+TEST(Algorithms, multiExp)
+{
+    EXPECT_EQ(multiExp(2ull, 10ull, 3ull, 4ull, 1000ull), (1024ull * 81ull) % 1000ull);
+    EXPECT_EQ(multiExp(2ull, 0ull, 3ull, 0ull, 7ull), 1ull);
+    EXPECT_EQ(multiExp(2ull, 5ull, 3ull, 5ull, 1ull), 0ull);
+
+    Mt19937RandomGenerator<1024, UnboundedInt> rnd{};
+    for (std::size_t i = 0; i < 20; ++i) {
+        UnboundedInt modulus = rnd() | ((i % 2) ? 1 : 0);
+        std::vector<UnboundedInt> bases{ rnd(), rnd(), rnd() };
+        std::vector<UnboundedInt> exps{ rnd(), rnd() >> (i * 40), UnboundedInt{ i } };
+
+        UnboundedInt expected = 1;
+        for (std::size_t j = 0; j < bases.size(); ++j) {
+            expected = expected * modexp(bases[j], exps[j], modulus) % modulus;
+        }
+
+        EXPECT_EQ(multiExp(bases, exps, modulus), expected);
+    }
+
+    EXPECT_THROW(multiExp<Uint64>({ 1, 2 }, { 1 }, 7), std::domain_error);
+}
+
+TEST(Algorithms, gcdexLarge)
+{
+    for (Uint32 bits : { 64, 65, 128, 512, 1024, 4096 }) {
+        Mt19937RandomGenerator<4096, UnboundedInt> rnd{};
+        const UnboundedInt mask = (UnboundedInt{ 1 } << bits) - 1;
+
+        for (std::size_t i = 0; i < 20; ++i) {
+            UnboundedInt a = rnd() & mask, b = rnd() & mask;
+            // Common factors, and operands of different lengths
+            if (i % 3 == 0) {
+                const UnboundedInt factor = rnd() & (mask >> (bits / 2));
+                a *= factor;
+                b *= factor;
+            }
+            if (i % 4 == 1)
+                b >>= bits / 3;
+
+            UnboundedInt x{}, y{};
+            const UnboundedInt d = gcdex(a, b, x, y);
+
+            EXPECT_EQ(d, boost::multiprecision::gcd(a, b));
+            EXPECT_EQ(cml::gcd(a, b), d);
+            EXPECT_EQ(a * x + b * y, d);
+            // Extended Euclid's coefficients are the minimal ones
+            if (d != 0) {
+                EXPECT_LE(abs(x), std::max<UnboundedInt>(b / d, 1));
+                EXPECT_LE(abs(y), std::max<UnboundedInt>(a / d, 1));
+            }
+        }
+    }
+
+    UnboundedInt x{}, y{};
+    EXPECT_EQ(gcdex(UnboundedInt{ 0 }, UnboundedInt{ 5 }, x, y), 5);
+    EXPECT_EQ(x, 0);
+    EXPECT_EQ(y, 1);
+    EXPECT_EQ(gcdex(UnboundedInt{ 5 }, UnboundedInt{ 0 }, x, y), 5);
+    EXPECT_EQ(x, 1);
+    EXPECT_EQ(y, 0);
+    EXPECT_EQ(gcdex(UnboundedInt{ 240 }, UnboundedInt{ 46 }, x, y), 2);
+    EXPECT_EQ(x, -9);
+    EXPECT_EQ(y, 47);
+
+    // Fixed width, the coefficients wrap modulo 2^512
+    const Uint512 a = (Uint512{ 1 } << 500) + 777, b = (Uint512{ 1 } << 499) + 12345;
+    Uint512 ux{}, uy{};
+    const Uint512 d = gcdex(a, b, ux, uy);
+    EXPECT_EQ(d, boost::multiprecision::gcd(a, b));
+    EXPECT_EQ(a * ux + b * uy, d);
+
+    Int64 sx = 0, sy = 0;
+    EXPECT_EQ(gcdex(Int64{ 240 }, Int64{ 46 }, sx, sy), 2);
+    EXPECT_EQ(sx, -9);
+    EXPECT_EQ(sy, 47);
+}
+
+TEST(Algorithms, invmod)
+{
+    EXPECT_EQ(invmod(3ull, 7ull), 5ull);
+    EXPECT_EQ(invmod(10ull, 7ull), 5ull);
+    EXPECT_EQ(invmod(5ull, 1ull), 0ull);
+    EXPECT_EQ(invmod(Int64{ -3 }, Int64{ 7 }), 2);
+    EXPECT_EQ(invmod(Uint64{ 0xFFFFFFFFFFFFFFFF }, Uint64{ 0xFFFFFFFFFFFFFFC5 }), 1590236558078409617ull);
+    EXPECT_THROW(invmod(6ull, 9ull), std::domain_error);
+    EXPECT_THROW(invmod(6ull, 0ull), std::domain_error);
+
+    Mt19937RandomGenerator<2048, UnboundedInt> rnd{};
+    for (std::size_t i = 0; i < 20; ++i) {
+        const UnboundedInt modulus = rnd() | 1;
+        const UnboundedInt number  = rnd();
+        if (boost::multiprecision::gcd(number, modulus) != 1) {
+            EXPECT_THROW(invmod(number, modulus), std::domain_error);
+            continue;
+        }
+
+        const UnboundedInt inverse = invmod(number, modulus);
+        EXPECT_GE(inverse, 0);
+        EXPECT_LT(inverse, modulus);
+        EXPECT_EQ(number * inverse % modulus, 1);
+    }
+
+    const Uint1024 modulus = (Uint1024{ 1 } << 1000) - 1, number = 65537;
+    EXPECT_EQ(Uint1024{ number * invmod(number, modulus) % modulus }, 1);
+}
+
+TEST(Algorithms, invmodBatch)
+{
+    // Prime modulus, only the multiples of it fail
+    const UnboundedInt prime = (UnboundedInt{ 1 } << 521) - 1;
+    Mt19937RandomGenerator<1024, UnboundedInt> rnd{};
+
+    std::vector<UnboundedInt> values{};
+    for (std::size_t i = 0; i < 50; ++i) {
+        values.push_back(i % 10 == 3 ? prime * i : rnd());
+    }
+    values[7] = -values[7];
+
+    InverseBatch<UnboundedInt> batch = invmodBatch(values, prime);
+    ASSERT_EQ(batch.inverses.size(), values.size());
+    EXPECT_EQ(batch.nonInvertible, (std::vector<std::size_t>{ 3, 13, 23, 33, 43 }));
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i % 10 == 3) {
+            EXPECT_EQ(batch.inverses[i], 0);
+        }
+        else {
+            EXPECT_EQ(batch.inverses[i], invmod(values[i], prime));
+        }
+    }
+
+    values[20] *= 3;
+    batch = invmodBatch(values, UnboundedInt{ prime * 3 });
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        const bool coprime = boost::multiprecision::gcd(values[i], prime * 3) == 1;
+        EXPECT_EQ(std::find(batch.nonInvertible.begin(), batch.nonInvertible.end(), i) == batch.nonInvertible.end(),
+                  coprime);
+        if (coprime) {
+            EXPECT_EQ(batch.inverses[i], invmod(values[i], UnboundedInt{ prime * 3 }));
+        }
+    }
+
+    // Composite modulus, the values sharing a factor are found without failing the rest
+    const std::vector<Uint64> numbers{ 1, 2, 3, 4, 5, 6, 7, 10, 11, 1000001, 0, 15 };
+    InverseBatch<Uint64> words = invmodBatch(numbers, Uint64{ 1000000005 });
+    EXPECT_EQ(words.nonInvertible, (std::vector<std::size_t>{ 2, 4, 5, 7, 10, 11 }));
+    for (std::size_t i = 0; i < numbers.size(); ++i) {
+        if (std::find(words.nonInvertible.begin(), words.nonInvertible.end(), i) != words.nonInvertible.end()) {
+            EXPECT_EQ(words.inverses[i], 0u);
+        }
+        else {
+            EXPECT_EQ(words.inverses[i], invmod(numbers[i], Uint64{ 1000000005 }));
+        }
+    }
+
+    EXPECT_EQ(invmodBatch(std::vector<Int64>{ -3, 3 }, Int64{ 7 }).inverses, (std::vector<Int64>{ 2, 5 }));
+    EXPECT_EQ(invmodBatch(std::vector<Uint64>{ 5, 0 }, Uint64{ 1 }).inverses, (std::vector<Uint64>{ 0, 0 }));
+    EXPECT_TRUE(invmodBatch(std::vector<Uint64>{}, Uint64{ 7 }).inverses.empty());
+    EXPECT_THROW(invmodBatch(std::vector<Uint64>{ 1 }, Uint64{ 0 }), std::domain_error);
+}
+
+TEST(Algorithms, mulLarge)
+{
+    Mt19937RandomGenerator<131072, UnboundedInt> rnd{};
+
+    // The transform itself, also below the threshold where mulLarge doesn't use it
+    for (std::size_t aCount : { 1, 2, 5, 100, 1000 }) {
+        for (std::size_t bCount : { 1, 3, 64, 700 }) {
+            UnboundedInt a = rnd() >> (131072 - 64 * aCount), b = rnd() >> (131072 - 64 * bCount);
+            // All ones maximizes the coefficients
+            if (aCount == 5)
+                a = (UnboundedInt{ 1 } << (64 * aCount)) - 1;
+            if (bCount == 700)
+                b = (UnboundedInt{ 1 } << (64 * bCount)) - 1;
+
+            std::vector<Limb> aLimbs(aCount), bLimbs(bCount), product(aCount + bCount);
+            detail::exportLimbs(a, aLimbs.data(), aCount);
+            detail::exportLimbs(b, bLimbs.data(), bCount);
+            detail::nttMultiplyLimbs(product.data(), aLimbs.data(), aCount, bLimbs.data(), bCount);
+
+            UnboundedInt result{};
+            detail::importLimbs(result, product.data(), product.size());
+            EXPECT_EQ(result, a * b);
+        }
+    }
+
+    const UnboundedInt a = rnd(), b = rnd() >> 50000;
+    EXPECT_EQ(mulLarge(a, b), a * b);
+    EXPECT_EQ(mulLarge(a, a), a * a);
+    EXPECT_EQ(mulLarge(UnboundedInt{ -a }, b), -(a * b));
+    EXPECT_EQ(mulLarge(UnboundedInt{ -a }, UnboundedInt{ -b }), a * b);
+    EXPECT_EQ(mulLarge(a, UnboundedInt{ 0 }), 0);
+}
+
+TEST(Algorithms, binpow)
+{
+    EXPECT_EQ(binpow(2ull, 10ull), 1024);
+    EXPECT_EQ(binpow(7ull, 0ull), 1);
+    EXPECT_EQ(binpow(0ull, 5ull), 0);
+    EXPECT_EQ(binpow(3ull, 200000ull), boost::multiprecision::pow(UnboundedInt{ 3 }, 200000));
+}
+
+TEST(Algorithms, constexprArithmetic)
+{
+    static_assert(constexprModexp(3u, 200u, 1000000007u) == 136318165u);
+    static_assert(constexprModexp(2ull, 64u, 18446744073709551557ull) == 59);
+    static_assert(gcd(12u, 18u) == 6);
+    static_assert(gcd(0ull, 7ull) == 7);
+
+    static_assert(deterministicMillerRabinTest(2u));
+    static_assert(!deterministicMillerRabinTest(1u));
+    static_assert(deterministicMillerRabinTest(4294967291u));
+    static_assert(!deterministicMillerRabinTest(3215031751u)); // strong pseudoprime to bases 2, 3, 5, 7
+    static_assert(deterministicMillerRabinTest(18446744073709551557ull));
+    static_assert(!deterministicMillerRabinTest(3825123056546413051ull)); // strong pseudoprime to bases below 37
+
+    constexpr auto primes = sievePrimes<2000>();
+    static_assert(primes.size() == 303);
+    static_assert(primes.front() == 2 && primes.back() == 1999);
+
+    // The sieve and the exact test agree below the sieve limit
+    std::size_t next = 0;
+    for (Uint32 number = 0; number < 2000; ++number) {
+        const bool listed = next < primes.size() && primes[next] == number;
+        EXPECT_EQ(deterministicMillerRabinTest(number), listed) << number;
+        next += listed ? 1 : 0;
+    }
+
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    for (int i = 0; i < 2000; ++i) {
+        const Uint64 number = randomGenerator() | 1;
+        Mt19937RandomGenerator<64, Uint64> witnessGenerator{};
+        EXPECT_EQ(deterministicMillerRabinTest(number), millerRabinTest(number, 20, witnessGenerator)) << number;
+    }
+}
+
+TEST(Algorithms, jacobiSymbol)
+{
+    EXPECT_EQ(jacobiSymbol(1u, 1u), 1);
+    EXPECT_EQ(jacobiSymbol(2u, 7u), 1);
+    EXPECT_EQ(jacobiSymbol(3u, 7u), -1);
+    EXPECT_EQ(jacobiSymbol(6u, 9u), 0);
+    EXPECT_EQ(jacobiSymbol(1001u, 9907u), -1);
+    EXPECT_EQ(jacobiSymbol(UnboundedInt{ 19 }, UnboundedInt{ 45 }), 1);
+
+    // Euler's criterion for a prime
+    const Uint64 prime = 1000000007;
+    for (Uint64 a = 1; a < 200; ++a) {
+        const Uint64 euler = modexp(a, (prime - 1) / 2, prime);
+        EXPECT_EQ(jacobiSymbol(a, prime), euler == 1 ? 1 : -1) << a;
+    }
+}
+
+TEST(Algorithms, bailliePswTest)
+{
+    for (Uint32 number = 0; number < 100000; ++number) {
+        EXPECT_EQ(bailliePswTest(number), deterministicMillerRabinTest(number)) << number;
+    }
+
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    for (int i = 0; i < 20000; ++i) {
+        const Uint64 number = randomGenerator() | 1;
+        EXPECT_EQ(bailliePswTest(number), deterministicMillerRabinTest(number)) << number;
+    }
+
+    // Strong pseudoprimes to base 2, strong Lucas pseudoprimes, Carmichael numbers and squares of primes
+    for (Uint64 number : { 2047ull, 3277ull, 4033ull, 4681ull, 8321ull, 5459ull, 5777ull, 10877ull, 16109ull,
+                           18971ull, 561ull, 41041ull, 3215031751ull, 3825123056546413051ull, 1018081ull,
+                           4294967291ull * 4294967291ull }) {
+        EXPECT_FALSE(bailliePswTest(number)) << number;
+    }
+
+    // Mersenne primes through every reduction width
+    const Uint128 m127 = (Uint128{ 1 } << 127) - 1;
+    EXPECT_TRUE(bailliePswTest(m127));
+    EXPECT_FALSE(bailliePswTest(Uint128{ m127 - 2 }));
+
+    const UnboundedInt m521 = (UnboundedInt{ 1 } << 521) - 1, m607 = (UnboundedInt{ 1 } << 607) - 1;
+    EXPECT_TRUE(bailliePswTest(m521));
+    EXPECT_TRUE(bailliePswTest(Uint1024{ m607 }));
+    EXPECT_FALSE(bailliePswTest(UnboundedInt{ m521 * m607 }));
+    EXPECT_FALSE(bailliePswTest(UnboundedInt{ m521 * m521 }));
+    EXPECT_FALSE(bailliePswTest(UnboundedInt{ m521 + 2 }));
+}
+
+TEST(Algorithms, bailliePswPolicy)
+{
+    using RandomGenerator = Mt19937RandomGenerator<256, Uint256>;
+    using PrimeGenerator  = MilRabPrimeGenerator<256, RandomGenerator, Uint256, BailliePswPolicy>;
+    using SafePrimeGenerator =
+        MilRabSafePrimeGenerator<MilRabPrimeGenerator<64, Mt19937RandomGenerator<64, Uint64>, Uint64, BailliePswPolicy>,
+                                 Mt19937RandomGenerator<128, Uint128>,
+                                 Uint128,
+                                 BailliePswPolicy>;
+
+    PrimeGenerator primeGenerator{};
+    SafePrimeGenerator safePrimeGenerator{};
+    RandomGenerator randomGenerator{};
+
+    for (int i = 0; i < 5; ++i) {
+        const Uint256 prime = primeGenerator();
+        EXPECT_EQ(bitLength(prime), 256u);
+        EXPECT_TRUE(millerRabinTest(prime, 64, randomGenerator));
+
+        const Uint128 safePrime = safePrimeGenerator();
+        EXPECT_TRUE(deterministicMillerRabinTest(static_cast<Uint64>(safePrime >> 1)));
+        EXPECT_TRUE(millerRabinTest(safePrime, 64, randomGenerator));
+    }
+}
+
+TEST(Algorithms, roundPolicies)
+{
+    static_assert(BitLengthRounds::rounds(2048) == 2048);
+    static_assert(ErrorBoundRounds<128>::rounds(2048) == 3);
+    static_assert(ErrorBoundRounds<112>::rounds(1024) == 5);
+    static_assert(ErrorBoundRounds<80>::rounds(8) == 40);
+
+    // Lengths between the rows take the row below
+    EXPECT_EQ(ErrorBoundRounds<100>::rounds(1023), ErrorBoundRounds<100>::rounds(768));
+    EXPECT_EQ(ErrorBoundRounds<100>::rounds(100000), 1u);
+
+    // More bits never need more rounds, a smaller error never fewer
+    for (Uint32 bits = 1; bits < 10000; ++bits) {
+        EXPECT_LE(ErrorBoundRounds<64>::rounds(bits + 1), ErrorBoundRounds<64>::rounds(bits));
+        EXPECT_LE(ErrorBoundRounds<128>::rounds(bits + 1), ErrorBoundRounds<128>::rounds(bits));
+        EXPECT_LE(ErrorBoundRounds<64>::rounds(bits), ErrorBoundRounds<80>::rounds(bits));
+        EXPECT_LE(ErrorBoundRounds<80>::rounds(bits), ErrorBoundRounds<100>::rounds(bits));
+        EXPECT_LE(ErrorBoundRounds<100>::rounds(bits), ErrorBoundRounds<112>::rounds(bits));
+        EXPECT_LE(ErrorBoundRounds<112>::rounds(bits), ErrorBoundRounds<128>::rounds(bits));
+        EXPECT_LE(ErrorBoundRounds<128>::rounds(bits), 64u);
+    }
+
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    EXPECT_EQ((primitiveRootModulo<Uint64, decltype(randomGenerator), ErrorBoundRounds<80>>(7, randomGenerator)), 3);
+    EXPECT_EQ((primitiveRootModulo<Uint64, decltype(randomGenerator), ErrorBoundRounds<80>>(9, randomGenerator)), 0);
+
+    using RandomGenerator = Mt19937RandomGenerator<512, Uint512>;
+    MilRabPrimeGenerator<512, RandomGenerator, Uint512, MillerRabinPolicy, BitLengthRounds> bitLengthGenerator{};
+    MilRabPrimeGenerator<512, RandomGenerator, Uint512, MillerRabinPolicy, ErrorBoundRounds<100>> errorBoundGenerator{};
+    EXPECT_TRUE(bailliePswTest(bitLengthGenerator()));
+    EXPECT_TRUE(bailliePswTest(errorBoundGenerator()));
+}
+
+TEST(Algorithms, deterministicPrimality)
+{
+    // The whole lookup table against the sieve
+    constexpr auto primes = sievePrimes<65536>();
+    std::size_t next      = 0;
+    for (Uint32 number = 0; number < 65536; ++number) {
+        const bool listed = next < primes.size() && primes[next] == number;
+        EXPECT_EQ(isPrime32(number), listed) << number;
+        next += listed ? 1 : 0;
+    }
+
+    EXPECT_TRUE(isPrime32(65537));
+    EXPECT_FALSE(isPrime32(65535));
+    EXPECT_FALSE(isPrime32(3215031751u)); // strong pseudoprime to bases 2, 3, 5, 7
+    EXPECT_FALSE(isPrime32(4294967295u));
+    EXPECT_TRUE(isPrime32(4294967291u));
+
+    EXPECT_FALSE(isPrime64(0));
+    EXPECT_FALSE(isPrime64(1));
+    EXPECT_TRUE(isPrime64(2));
+    EXPECT_TRUE(isPrime64(4294967311ull));
+    EXPECT_FALSE(isPrime64(4294967297ull)); // 641 * 6700417
+    EXPECT_FALSE(isPrime64(3825123056546413051ull)); // strong pseudoprime to bases below 37
+    EXPECT_FALSE(isPrime64(18446744073709551615ull));
+    EXPECT_TRUE(isPrime64(18446744073709551557ull));
+
+    // Around 2^32, where isPrime64 switches tests, and random words against Baillie-PSW
+    for (Uint64 number = 4294967296ull - 2000; number < 4294967296ull + 2000; ++number) {
+        EXPECT_EQ(isPrime64(number), deterministicMillerRabinTest(number)) << number;
+    }
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    for (int i = 0; i < 20000; ++i) {
+        const Uint64 number = randomGenerator();
+        EXPECT_EQ(isPrime64(number), bailliePswTest(number)) << number;
+        EXPECT_EQ(isPrime32(static_cast<Uint32>(number)), deterministicMillerRabinTest(static_cast<Uint32>(number)));
+    }
+
+    // millerRabinTest takes the exact path for built-in widths, the generator is never drawn from
+    Mt19937RandomGenerator<64, Uint64> unusedGenerator{};
+    EXPECT_FALSE(millerRabinTest(3825123056546413051ull, 1, unusedGenerator));
+    EXPECT_TRUE(millerRabinTest(4294967291u, 1, unusedGenerator));
+}
+
+TEST(Algorithms, millerRabinBatch)
+{
+    // Primes below 2^64 and their neighbours, random words, small numbers, counts off the lane width
+    std::vector<Uint64> numbers{ 0, 1, 2, 4294967291u, 4294967297ull, 3825123056546413051ull };
+    for (Uint64 number = 18446744073709551615ull; numbers.size() < 1000; --number) {
+        numbers.push_back(number);
+    }
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    for (int i = 0; i < 5000; ++i) {
+        numbers.push_back(randomGenerator() >> (i % 64));
+    }
+
+    for (std::size_t count : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 7 }, numbers.size() }) {
+        const std::vector<Uint64> batch(numbers.begin(), numbers.begin() + count);
+        const std::vector<bool> results = millerRabinBatch(batch);
+        ASSERT_EQ(results.size(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(results[i], isPrime64(batch[i])) << batch[i];
+        }
+    }
+}
+
+TEST(Algorithms, productTree)
+{
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+    const auto randomNumber = [&](std::size_t limbs) {
+        UnboundedInt number = 0;
+        for (std::size_t i = 0; i < limbs; ++i) {
+            number = (number << 64) | randomGenerator();
+        }
+        return number;
+    };
+
+    // Knuth division and the Newton path against cpp_int, the divisor sizes around newtonDivisionMinLimbs
+    for (std::size_t limbs : { std::size_t{ 1 }, std::size_t{ 3 }, std::size_t{ 40 }, newtonDivisionMinLimbs + 7 }) {
+        for (std::size_t numberLimbs : { limbs / 2, limbs, 2 * limbs, 5 * limbs + 1 }) {
+            const UnboundedInt number  = randomNumber(numberLimbs);
+            const UnboundedInt divisor = randomNumber(limbs) | 1;
+            EXPECT_EQ(detail::remainderLarge(number, divisor), number % divisor) << limbs << " " << numberLimbs;
+        }
+    }
+
+    const UnboundedInt divisor = randomNumber(newtonDivisionMinLimbs + 7) | 1;
+    const Uint32 bits          = bitLength(divisor);
+    EXPECT_EQ(detail::reciprocal(divisor, bits), (UnboundedInt{ 1 } << (2 * bits)) / divisor);
+
+    std::vector<UnboundedInt> leaves{};
+    for (std::size_t i = 1; i <= 37; ++i) {
+        leaves.push_back(randomNumber(i % 5 + 1) | 1);
+    }
+    const ProductTree tree{ leaves };
+    ASSERT_EQ(tree.leafCount(), leaves.size());
+
+    UnboundedInt product = 1;
+    for (const UnboundedInt& leaf : leaves) {
+        product *= leaf;
+    }
+    EXPECT_EQ(tree.root(), product);
+
+    const UnboundedInt number                  = randomNumber(200);
+    const std::vector<UnboundedInt> remainders = tree.remainders(number);
+    for (std::size_t i = 0; i < leaves.size(); ++i) {
+        EXPECT_EQ(remainders[i], number % leaves[i]) << i;
+    }
+
+    EXPECT_THROW(ProductTree{ std::vector<UnboundedInt>{} }, std::domain_error);
+    EXPECT_THROW((ProductTree{ { 3, 0 } }), std::domain_error);
+}
+
+TEST(Algorithms, batchTrialDivision)
+{
+    const BatchTrialDivision division{ 1000 };
+    ASSERT_EQ(division.primes().size(), 1000);
+    EXPECT_EQ(division.primes().back(), 7919);
+
+    // Small numbers, primes among the divisors, a square of one and a product of two primes above them
+    const std::vector<Uint64> small{ 0, 1, 2, 3, 4, 9, 7919, 7921, 7927, 62710561, 62884891, 1000003 };
+    const std::vector<bool> smallExpected{ false, false, true,  true,  false, false,
+                                           true,  false, true,  false, true,  true };
+    EXPECT_EQ(division.survivors(small), smallExpected);
+
+    Mt19937RandomGenerator<512, Uint512> randomGenerator{};
+    std::vector<Uint512> candidates{};
+    for (int i = 0; i < 300; ++i) {
+        candidates.push_back(randomGenerator());
+    }
+
+    const std::vector<bool> survivors = division.survivors(candidates);
+    ASSERT_EQ(survivors.size(), candidates.size());
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        bool expected = true;
+        for (Uint32 prime : division.primes()) {
+            expected = expected && candidates[i] % prime != 0;
+        }
+        EXPECT_EQ(survivors[i], expected) << candidates[i];
+    }
+}
+
+TEST(Algorithms, parallelMillerRabin)
+{
+    // Every index once, a false task stops the run, an exception comes back to the caller
+    std::vector<std::atomic<int>> visits(1000);
+    EXPECT_TRUE(detail::parallelAll(
+        visits.size(), [](std::size_t worker) { return worker; },
+        [&](std::size_t, std::size_t index) {
+            ++visits[index];
+            return true;
+        }));
+    for (const std::atomic<int>& count : visits) {
+        EXPECT_EQ(count, 1);
+    }
+
+    EXPECT_FALSE(detail::parallelAll(
+        100, [](std::size_t) { return 0; }, [](int, std::size_t index) { return index != 10; }));
+    EXPECT_THROW(detail::parallelAll(
+                     100, [](std::size_t) { return 0; },
+                     [](int, std::size_t index) -> bool { throw std::domain_error{ std::to_string(index) }; }),
+                 std::domain_error);
+
+    MilRabPrimeGenerator<512, Mt19937RandomGenerator<512, UnboundedInt>, UnboundedInt, BailliePswPolicy>
+        primeGenerator{};
+    Mt19937RandomGenerator<512, UnboundedInt> randomGenerator{};
+    for (int i = 0; i < 5; ++i) {
+        const UnboundedInt p = primeGenerator(), q = primeGenerator();
+        EXPECT_TRUE(millerRabinTest(p, 16, randomGenerator, LaunchPolicy::Parallel)) << p;
+        EXPECT_FALSE(millerRabinTest(UnboundedInt{ p * q }, 16, randomGenerator, LaunchPolicy::Parallel)) << p;
+    }
+
+    // Strong pseudoprime to bases 2, 3, 5 and 7, most random bases are witnesses
+    EXPECT_FALSE(millerRabinTest(UnboundedInt{ 3215031751u }, 20, randomGenerator, LaunchPolicy::Parallel));
+    EXPECT_TRUE(millerRabinTest(UnboundedInt{ 4294967291u }, 1, randomGenerator, LaunchPolicy::Parallel));
+}
+
+TEST(Algorithms, primeSieve)
+{
+    const auto listed = [](Uint64 lo, Uint64 hi) {
+        std::vector<Uint64> primes{};
+        for (Uint64 prime : primesInRange(lo, hi)) {
+            primes.push_back(prime);
+        }
+        return primes;
+    };
+    const auto tested = [](Uint64 lo, Uint64 hi) {
+        std::vector<Uint64> primes{};
+        for (Uint64 number = lo; number < hi; ++number) {
+            if (isPrime64(number))
+                primes.push_back(number);
+        }
+        return primes;
+    };
+
+    EXPECT_EQ(listed(0, 10000), tested(0, 10000));
+    EXPECT_EQ(listed(2, 3), std::vector<Uint64>{ 2 });
+    EXPECT_EQ(listed(3, 4), std::vector<Uint64>{ 3 });
+    EXPECT_TRUE(listed(0, 2).empty());
+    EXPECT_TRUE(listed(24, 29).empty());
+    EXPECT_TRUE(listed(100, 10).empty());
+
+    // Several segments, and sieving primes beyond the constant table
+    const Uint64 large = Uint64{ 1 } << 40;
+    EXPECT_EQ(listed(large - 3000000, large + 1000), tested(large - 3000000, large + 1000));
+    EXPECT_EQ(countPrimes(large - 3000000, large + 1000), tested(large - 3000000, large + 1000).size());
+
+    EXPECT_EQ(countPrimes(0, 0), 0);
+    EXPECT_EQ(countPrimes(0, 3), 1);
+    EXPECT_EQ(countPrimes(2, 4), 2);
+    EXPECT_EQ(countPrimes(1000, 100), 0);
+    EXPECT_EQ(countPrimes(0, 10000000), 664579);
+    EXPECT_EQ(countPrimes(0, 100000000), 5761455);
+    EXPECT_EQ(countPrimes(1000000, 100000000), 5761455 - 78498);
+}
+
+TEST(Algorithms, candidateSearch)
+{
+    // Starts handed out in turn, in place of random numbers
+    std::vector<Uint64> starts{};
+    std::size_t draws = 0;
+    const auto next   = [&](Uint64, Uint64) { return starts[draws++ % starts.size()]; };
+
+    const auto firstPrimeFrom = [](Uint64 number) {
+        while (!isPrime64(number)) {
+            number += 2;
+        }
+        return number;
+    };
+
+    // The first prime upwards from the start, or a new start when none is left below 2^64
+    starts = { 0x8000000000000000ull, 0xC3A5C85C97CB3127ull, 0xFFFFFFFFFFFFFFD1ull, 0x9E3779B97F4A7C15ull };
+    EXPECT_EQ((SieveSearch::search<64, Uint64>(next, isPrime64)), firstPrimeFrom(0x8000000000000001ull));
+    EXPECT_EQ((SieveSearch::search<64, Uint64>(next, isPrime64)), firstPrimeFrom(0xC3A5C85C97CB3127ull));
+    EXPECT_EQ((SieveSearch::search<64, Uint64>(next, isPrime64)), firstPrimeFrom(0x9E3779B97F4A7C15ull));
+    EXPECT_EQ(draws, 4u);
+
+    // Candidates reaching the test have no factor below 2000
+    starts = { 0xC3A5C85C97CB3127ull };
+    std::size_t tested = 0;
+    SieveSearch::search<64, Uint64>(next, [&](Uint64 candidate) {
+        ++tested;
+        for (Uint32 prime : sievePrimes<2000>()) {
+            EXPECT_NE(candidate % prime, 0u) << candidate;
+        }
+        return tested == 20;
+    });
+    tested = 0;
+    RandomSearch::search<64, Uint64>(next, [&](Uint64 candidate) {
+        ++tested;
+        EXPECT_EQ(candidate, 0xC3A5C85C97CB3127ull);
+        return tested == 2;
+    });
+
+    using RandomGenerator = Mt19937RandomGenerator<64, Uint64>;
+    MilRabPrimeGenerator<64, RandomGenerator, Uint64, MillerRabinPolicy, ErrorBoundRounds<128>, SieveSearch>
+        sieveGenerator{};
+    MilRabPrimeGenerator<64, RandomGenerator, Uint64, MillerRabinPolicy, ErrorBoundRounds<128>, RandomSearch>
+        randomGenerator{};
+    MilRabPrimeGenerator<512, Mt19937RandomGenerator<512, Uint512>> largeGenerator{};
+    for (int i = 0; i < 20; ++i) {
+        const Uint64 sievePrime = sieveGenerator(), randomPrime = randomGenerator();
+        EXPECT_EQ(bitLength(sievePrime), 64u);
+        EXPECT_EQ(bitLength(randomPrime), 64u);
+        EXPECT_TRUE(isPrime64(sievePrime)) << sievePrime;
+        EXPECT_TRUE(isPrime64(randomPrime)) << randomPrime;
+    }
+    const Uint512 prime = largeGenerator();
+    EXPECT_EQ(bitLength(prime), 512u);
+    EXPECT_TRUE(bailliePswTest(prime));
+}
+
+TEST(Algorithms, parallelPrimeSearch)
+{
+    using RandomGenerator = Mt19937RandomGenerator<64, Uint64>;
+    MilRabPrimeGenerator<64, RandomGenerator> sieveGenerator{};
+    MilRabPrimeGenerator<64, RandomGenerator, Uint64, MillerRabinPolicy, ErrorBoundRounds<128>, RandomSearch>
+        randomGenerator{};
+    for (int i = 0; i < 20; ++i) {
+        for (Uint64 prime : { sieveGenerator(LaunchPolicy::Parallel), randomGenerator(LaunchPolicy::Parallel) }) {
+            EXPECT_EQ(bitLength(prime), 64u);
+            EXPECT_TRUE(isPrime64(prime)) << prime;
+        }
+    }
+
+    // Callers on several threads, each spreading its own search, next to Async callers of the same generator
+    MilRabPrimeGenerator<512, Mt19937RandomGenerator<512, Uint512>, Uint512, BailliePswPolicy> largeGenerator{};
+    std::vector<Uint512> primes(6);
+    std::vector<std::thread> callers{};
+    for (std::size_t i = 0; i < primes.size(); ++i) {
+        const LaunchPolicy policy = i % 3 == 2 ? LaunchPolicy::Async : LaunchPolicy::Parallel;
+        callers.emplace_back([&, i, policy] { primes[i] = largeGenerator(policy); });
+    }
+    for (std::thread& caller : callers) {
+        caller.join();
+    }
+    for (const Uint512& prime : primes) {
+        EXPECT_EQ(bitLength(prime), 512u);
+        EXPECT_TRUE(bailliePswTest(prime)) << prime;
+    }
+}
+
+TEST(Algorithms, safePrimeSearch)
+{
+    // Windows of both sieves: q survives the double one exactly when neither q nor 2 * q + 1 has a small factor
+    const Uint64 start                = 0xC3A5C85C97CB3127ull;
+    const std::size_t primeCount      = detail::windowPrimeCount(64);
+    const std::vector<Uint32>& primes = detail::windowPrimes().primes;
+    std::array<bool, 128> single{}, safe{};
+    detail::crossOffWindow(start, single.size(), primeCount, false, single.data());
+    detail::crossOffWindow(start, safe.size(), primeCount, true, safe.data());
+    for (std::size_t j = 0; j < safe.size(); ++j) {
+        const Uint64 q     = start + 2 * j;
+        bool qComposite    = false;
+        bool safeComposite = false;
+        for (std::size_t i = 0; i < primeCount; ++i) {
+            qComposite |= q % primes[i] == 0;
+            safeComposite |= (Uint128{ q } * 2 + 1) % primes[i] == 0;
+        }
+        EXPECT_EQ(single[j], qComposite) << j;
+        EXPECT_EQ(safe[j], qComposite || safeComposite) << j;
+    }
+
+    using RandomGenerator = Mt19937RandomGenerator<64, Uint64>;
+    using PrimeGenerator  = MilRabPrimeGenerator<64, RandomGenerator, Uint64>;
+    MilRabSafePrimeGenerator<PrimeGenerator, Mt19937RandomGenerator<128, Uint128>> sieveGenerator{};
+    MilRabSafePrimeGenerator<PrimeGenerator,
+                             Mt19937RandomGenerator<128, Uint128>,
+                             Uint128,
+                             MillerRabinPolicy,
+                             ErrorBoundRounds<128>,
+                             InnerGeneratorSearch>
+        innerGenerator{};
+    Mt19937RandomGenerator<128, Uint128> randomGenerator{};
+    for (int i = 0; i < 5; ++i) {
+        for (const Uint128& safePrime : { sieveGenerator(), innerGenerator() }) {
+            EXPECT_EQ(bitLength(safePrime), 65u);
+            EXPECT_TRUE(isPrime64(static_cast<Uint64>(safePrime >> 1))) << safePrime;
+            EXPECT_TRUE(millerRabinTest(safePrime, 64, randomGenerator)) << safePrime;
+        }
+    }
+
+    // A prime generator that states no bitness, as a pool, has q drawn from it by default
+    using PoolGenerator = MilRabSafePrimeGenerator<PrimePool<PrimeGenerator>, Mt19937RandomGenerator<128, Uint128>>;
+    static_assert(std::is_same<decltype(sieveGenerator)::SearchPolicy, DoubleSieveSearch>::value);
+    static_assert(std::is_same<PoolGenerator::SearchPolicy, InnerGeneratorSearch>::value);
+    PoolGenerator poolGenerator{};
+    const Uint128 pooledSafePrime = poolGenerator();
+    EXPECT_EQ(bitLength(pooledSafePrime), 65u);
+    EXPECT_TRUE(isPrime64(static_cast<Uint64>(pooledSafePrime >> 1))) << pooledSafePrime;
+    EXPECT_TRUE(millerRabinTest(pooledSafePrime, 64, randomGenerator)) << pooledSafePrime;
+
+    using Value = Uint512;
+    MilRabSafePrimeGenerator<MilRabPrimeGenerator<256, Mt19937RandomGenerator<256, Uint256>, Uint256>,
+                             Mt19937RandomGenerator<512, Value>>
+        largeGenerator{};
+    const Value safePrime = largeGenerator();
+    EXPECT_EQ(bitLength(safePrime), 257u);
+    EXPECT_TRUE(bailliePswTest(safePrime));
+    EXPECT_TRUE(bailliePswTest(Value{ safePrime >> 1 }));
+}
+
+TEST(Algorithms, pocklingtonSafePrimeTest)
+{
+    // Exact once q is prime
+    for (Uint64 q : primesInRange(2, 100000)) {
+        EXPECT_EQ(pocklingtonSafePrimeTest(2 * q + 1), isPrime64(2 * q + 1)) << q;
+    }
+
+    // The 768-bit safe prime of RFC 2409's first Oakley group, and odd numbers past it
+    const Uint1024 oakley{ "0xFFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129024E088A67CC74020BBEA63B139B22514A0879"
+                           "8E3404DDEF9519B3CD3A431B302B0A6DF25F14374FE1356D6D51C245E485B576625E7EC6F44C42E9A63A3620"
+                           "FFFFFFFFFFFFFFFF" };
+    EXPECT_TRUE(pocklingtonSafePrimeTest(oakley));
+    EXPECT_TRUE(bailliePswTest(Uint1024{ oakley >> 1 }));
+    EXPECT_FALSE(pocklingtonSafePrimeTest(Uint1024{ oakley + 2 }));
+    EXPECT_FALSE(pocklingtonSafePrimeTest(Uint1024{ oakley + 4 }));
+}
+
+TEST(Algorithms, pipelinedSafePrime)
+{
+    using RandomGenerator = Mt19937RandomGenerator<128, Uint128>;
+    using PrimeGenerator  = MilRabPrimeGenerator<64, Mt19937RandomGenerator<64, Uint64>, Uint64>;
+    MilRabSafePrimeGenerator<PrimeGenerator, RandomGenerator> sieveGenerator{};
+    MilRabSafePrimeGenerator<PrimeGenerator,
+                             RandomGenerator,
+                             Uint128,
+                             MillerRabinPolicy,
+                             ErrorBoundRounds<128>,
+                             InnerGeneratorSearch>
+        innerGenerator{};
+
+    // Several searches under way at once, from one generator
+    std::vector<std::future<Uint128>> futures{};
+    for (int i = 0; i < 4; ++i) {
+        futures.push_back(sieveGenerator.generatePipelined());
+    }
+    futures.push_back(innerGenerator.generatePipelined());
+
+    std::vector<Uint128> safePrimes{};
+    for (std::future<Uint128>& future : futures) {
+        safePrimes.push_back(future.get());
+    }
+    for (int i = 0; i < 5; ++i) {
+        safePrimes.push_back(sieveGenerator(LaunchPolicy::Parallel));
+        safePrimes.push_back(innerGenerator(LaunchPolicy::Parallel));
+    }
+
+    RandomGenerator randomGenerator{};
+    for (const Uint128& safePrime : safePrimes) {
+        EXPECT_EQ(bitLength(safePrime), 65u);
+        EXPECT_TRUE(isPrime64(static_cast<Uint64>(safePrime >> 1))) << safePrime;
+        EXPECT_TRUE(millerRabinTest(safePrime, 64, randomGenerator)) << safePrime;
+    }
+
+    MilRabSafePrimeGenerator<MilRabPrimeGenerator<256, Mt19937RandomGenerator<256, Uint256>, Uint256>,
+                             Mt19937RandomGenerator<512, Uint512>>
+        largeGenerator{};
+    const Uint512 safePrime = largeGenerator.generatePipelined().get();
+    EXPECT_EQ(bitLength(safePrime), 257u);
+    EXPECT_TRUE(bailliePswTest(safePrime));
+    EXPECT_TRUE(bailliePswTest(Uint512{ safePrime >> 1 }));
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions of the test binary. Each thread counts its own allocations, so
+// background threads of other tests never show in a comparison around a call
+
+namespace {
+
+thread_local std::size_t allocationCount = 0;
+
+void* allocate(std::size_t size)
+{
+    ++allocationCount;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+} // namespace
+
+std::size_t threadAllocationCount()
+{
+    return allocationCount;
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* pointer = allocate(size))
+        return pointer;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* pointer = allocate(size))
+        return pointer;
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
\ No newline at end of file
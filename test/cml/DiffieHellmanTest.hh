@@ -6,7 +6,7 @@
 using namespace cml;
 
 template <uint32_t bitness>
-void testDiffieHellman(bool print = false)
+void testDiffieHellman(bool print = false, bool precompute = false, LaunchPolicy policy = LaunchPolicy::Sync)
 {
     using Value           = typename ContainerByBitness<bitness>::Type;
     using RandomGenerator = Mt19937RandomGenerator<bitness, Value>;
@@ -16,7 +16,10 @@ void testDiffieHellman(bool print = false)
 
     PrimeGenerator primeGenerator{};
     RandomGenerator randomGenerator{};
-    SecurityBase base = SecurityBase::create(primeGenerator, randomGenerator);
+    SecurityBase base = SecurityBase::create(primeGenerator, randomGenerator, policy);
+
+    if (precompute)
+        base.precompute();
 
     Protocol aliceKeyGenerator{};
     Protocol bobKeyGenerator{};
@@ -100,4 +103,22 @@ TEST(DiffieHellmanProtocol, InWork_60_x50)
     for (std::size_t i = 0; i < 50; ++i) {
         testDiffieHellman<bitness>(false);
     }
+}
+
+TEST(DiffieHellmanProtocol, InWork_Precomputed_60_x50)
+{
+    constexpr uint32_t bitness = 60;
+
+    for (std::size_t i = 0; i < 50; ++i) {
+        testDiffieHellman<bitness>(false, true);
+    }
+}
+
+TEST(DiffieHellmanProtocol, InWork_Parallel_60_x50)
+{
+    constexpr uint32_t bitness = 60;
+
+    for (std::size_t i = 0; i < 50; ++i) {
+        testDiffieHellman<bitness>(false, false, LaunchPolicy::Parallel);
+    }
 }
\ No newline at end of file
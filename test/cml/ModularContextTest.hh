@@ -0,0 +1,443 @@
+#pragma once
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cml/cml.hh>
+
+using namespace cml;
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void testMontgomeryAgainstDivision(std::size_t testsAmount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        Value modulus = randomGenerator() | 1;
+        if (modulus < 3)
+            continue;
+
+        Value base = randomGenerator();
+        Value exp  = randomGenerator();
+
+        MontgomeryContext<Value> montgomery{ modulus };
+        DivisionContext<Value> division{ modulus };
+
+        EXPECT_EQ(montgomery.modexp(base, exp), division.modexp(base, exp));
+        EXPECT_EQ(montgomery.fromResidue(montgomery.toResidue(base)), base % modulus);
+
+        auto product = montgomery.multiply(montgomery.toResidue(base), montgomery.toResidue(exp));
+        EXPECT_EQ(montgomery.fromResidue(product), division.fromResidue(division.multiply(
+                                                       division.toResidue(base), division.toResidue(exp))));
+    }
+}
+
+TEST(ModularContext, montgomeryMatchesDivision_16)
+{
+    testMontgomeryAgainstDivision<16>(1000);
+}
+
+TEST(ModularContext, montgomeryMatchesDivision_64)
+{
+    testMontgomeryAgainstDivision<64>(1000);
+}
+
+TEST(ModularContext, montgomeryMatchesDivision_128)
+{
+    testMontgomeryAgainstDivision<128>(500);
+}
+
+TEST(ModularContext, montgomeryMatchesDivision_512)
+{
+    testMontgomeryAgainstDivision<512>(50);
+}
+
+TEST(ModularContext, montgomeryMatchesDivision_2048)
+{
+    testMontgomeryAgainstDivision<2048>(5);
+}
+
+TEST(ModularContext, montgomeryEdgeCases)
+{
+    EXPECT_THROW(MontgomeryContext<Uint64>{ 0 }, std::domain_error);
+    EXPECT_THROW(MontgomeryContext<Uint64>{ 1 }, std::domain_error);
+    EXPECT_THROW(MontgomeryContext<Uint64>{ 10 }, std::domain_error);
+
+    MontgomeryContext<Uint64> context{ 0xFFFFFFFFFFFFFFC5ull };
+    EXPECT_EQ(context.modexp(0xFFFFFFFFFFFFFFC4ull, 2ull), 1ull);
+    EXPECT_EQ(context.modexp(5ull, 0ull), 1ull);
+    EXPECT_EQ(context.modexp(0ull, 5ull), 0ull);
+
+    UnboundedInt modulus = (UnboundedInt{ 1 } << 521) - 1;
+    MontgomeryContext<UnboundedInt> wideContext{ modulus };
+    EXPECT_EQ(wideContext.modexp(UnboundedInt{ 3 }, modulus - 1), 1);
+    EXPECT_EQ(modexp(UnboundedInt{ 3 }, UnboundedInt{ modulus - 1 }, modulus), 1);
+}
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void testBarrettAgainstDivision(std::size_t testsAmount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        // Even moduli as well, Barrett reduction serves any modulus above 1
+        Value modulus = randomGenerator();
+        if (modulus < 2)
+            continue;
+
+        Value base = randomGenerator();
+        Value exp  = randomGenerator();
+
+        BarrettContext<Value> barrett{ modulus };
+        DivisionContext<Value> division{ modulus };
+
+        EXPECT_EQ(barrett.modexp(base, exp), division.modexp(base, exp));
+        EXPECT_EQ(barrett.fromResidue(barrett.toResidue(base)), base % modulus);
+    }
+}
+
+TEST(ModularContext, barrettMatchesDivision_64)
+{
+    testBarrettAgainstDivision<64>(1000);
+}
+
+TEST(ModularContext, barrettMatchesDivision_128)
+{
+    testBarrettAgainstDivision<128>(500);
+}
+
+TEST(ModularContext, barrettMatchesDivision_512)
+{
+    testBarrettAgainstDivision<512>(50);
+}
+
+TEST(ModularContext, barrettMatchesDivision_2048)
+{
+    testBarrettAgainstDivision<2048>(5);
+}
+
+TEST(ModularContext, barrettEdgeCases)
+{
+    EXPECT_THROW(BarrettContext<Uint64>{ 0 }, std::domain_error);
+    EXPECT_THROW(BarrettContext<Uint64>{ 1 }, std::domain_error);
+
+    EXPECT_EQ(BarrettContext<Uint64>{ 2 }.modexp(3ull, 5ull), 1ull);
+    EXPECT_EQ(BarrettContext<Uint64>{ 0xFFFFFFFFFFFFFFFFull }.modexp(0xFFFFFFFFFFFFFFFEull, 3ull),
+              0xFFFFFFFFFFFFFFFEull);
+
+    // Reciprocal of a power of the limb radix doesn't fit its limbs and is clamped
+    const UnboundedInt radix = UnboundedInt{ 1 } << 128;
+    BarrettContext<UnboundedInt> clamped{ radix };
+    DivisionContext<UnboundedInt> division{ radix };
+    const UnboundedInt base = radix - 3;
+    for (Uint32 exp : { 0, 1, 2, 3, 17, 255 }) {
+        EXPECT_EQ(clamped.modexp(base, exp), division.modexp(base, exp));
+    }
+
+    UnboundedInt modulus = (UnboundedInt{ 1 } << 521) - 1;
+    EXPECT_EQ(BarrettContext<UnboundedInt>{ modulus }.modexp(UnboundedInt{ 3 }, modulus - 1), 1);
+}
+
+TEST(ModularContext, chooseReduction)
+{
+    const Uint512 modulus = (Uint512{ 1 } << 511) + 1;
+
+    EXPECT_EQ(chooseReduction(Uint64{ 1000003 }, 1), Reduction::Division);
+    EXPECT_EQ(chooseReduction(Uint64{ 1000003 }, 1000), Reduction::Montgomery);
+    EXPECT_EQ(chooseReduction(Uint64{ 1000004 }, 1000), Reduction::Division);
+    EXPECT_EQ(chooseReduction(Int64{ 1000003 }, 1000), Reduction::Division);
+    EXPECT_EQ(chooseReduction(modulus, 1), Reduction::Division);
+    EXPECT_EQ(chooseReduction(modulus, 8), Reduction::Barrett);
+    EXPECT_EQ(chooseReduction(modulus, 512), Reduction::Montgomery);
+    EXPECT_EQ(chooseReduction(Uint512{ modulus + 1 }, 512), Reduction::Barrett);
+
+    // Every choice has to agree with plain division
+    const Uint512 base = (Uint512{ 1 } << 300) + 12345;
+    for (Uint32 expBits : { 1, 3, 8, 30, 512 }) {
+        const Uint512 exp = (Uint512{ 1 } << (expBits - 1)) + 1;
+        EXPECT_EQ(modexp(base, exp, modulus), DivisionContext<Uint512>{ modulus }.modexp(base, exp));
+        EXPECT_EQ(modexp(base, exp, Uint512{ modulus + 1 }),
+                  DivisionContext<Uint512>{ Uint512{ modulus + 1 } }.modexp(base, exp));
+    }
+}
+
+template <typename Value>
+void testWordMontgomeryAgainstDivision(std::size_t testsAmount)
+{
+    Mt19937RandomGenerator<std::numeric_limits<Value>::digits, Value> randomGenerator{};
+
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        Value modulus = randomGenerator() | 1;
+        if (modulus < 3)
+            continue;
+
+        Value base = randomGenerator();
+        Value exp  = randomGenerator();
+
+        WordMontgomeryContext<Value> word{ modulus };
+        DivisionContext<Value> division{ modulus };
+
+        EXPECT_EQ(word.modexp(base, exp), division.modexp(base, exp));
+        EXPECT_EQ(word.fromResidue(word.toResidue(base)), base % modulus);
+    }
+}
+
+TEST(ModularContext, wordMontgomeryMatchesDivision)
+{
+    testWordMontgomeryAgainstDivision<Uint16>(1000);
+    testWordMontgomeryAgainstDivision<Uint32>(1000);
+    testWordMontgomeryAgainstDivision<Uint64>(1000);
+    testWordMontgomeryAgainstDivision<unsigned long long>(1000);
+}
+
+TEST(ModularContext, wordMontgomeryEdgeCases)
+{
+    EXPECT_THROW(WordMontgomeryContext<Uint64>{ 1 }, std::domain_error);
+    EXPECT_THROW(WordMontgomeryContext<Uint64>{ 10 }, std::domain_error);
+
+    WordMontgomeryContext<Uint64> context{ 0xFFFFFFFFFFFFFFC5ull };
+    EXPECT_EQ(context.modexp(0xFFFFFFFFFFFFFFC4ull, 2ull), 1ull);
+    EXPECT_EQ(context.modexp(2ull, 0xFFFFFFFFFFFFFFC4ull), 1ull);
+    EXPECT_EQ(context.modexp(5ull, 0ull), 1ull);
+    EXPECT_EQ(context.modexp(0ull, 5ull), 0ull);
+
+    EXPECT_EQ(WordMontgomeryContext<Uint8>{ 3 }.modexp(2, 2u), 1);
+    EXPECT_EQ(WordMontgomeryContext<Uint64>{ 0xFFFFFFFFFFFFFFFFull }.modexp(2ull, 64ull), 1ull);
+
+#if defined(__SIZEOF_INT128__)
+    EXPECT_TRUE((std::is_same<DivisionContext<unsigned long long>::Residue, unsigned __int128>::value));
+#endif
+    EXPECT_EQ(modexp<unsigned long long>(3, 0xFFFFFFFFFFFFFFC4ull, 0xFFFFFFFFFFFFFFC5ull), 1ull);
+    EXPECT_EQ(UnboundedInt{ modexp<Uint64>(3, 0xFFFFFFFFFFFFFFC4ull, 0xFFFFFFFFFFFFFFC6ull) },
+              modexp<UnboundedInt>(3, 0xFFFFFFFFFFFFFFC4ull, 0xFFFFFFFFFFFFFFC6ull));
+}
+
+template <class Context>
+void testResidueAddition(const typename Context::Value& modulus, std::size_t testsAmount)
+{
+    using Value = typename Context::Value;
+
+    const Context context{ modulus };
+    const detail::ResidueAddition<Context> addition{ context };
+    Mt19937RandomGenerator<64, Uint64> randomGenerator{};
+
+    const auto random = [&] {
+        UnboundedInt number = 0;
+        for (std::size_t i = 0; i < 20; ++i) {
+            number = (number << 64) | randomGenerator();
+        }
+        return static_cast<Value>(number % UnboundedInt{ modulus });
+    };
+
+    typename Context::Residue result{};
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        // Edge values first: zero, one and modulus - 1
+        const Value a = i == 0 ? Value{ 0 } : i == 1 ? Value{ modulus - 1 } : random();
+        const Value b = i == 0 ? Value{ 1 } : i == 1 ? Value{ modulus - 1 } : random();
+        const auto x = context.toResidue(a), y = context.toResidue(b);
+
+        const UnboundedInt wideA{ a }, wideB{ b }, wideModulus{ modulus };
+
+        addition.add(result, x, y);
+        EXPECT_EQ(UnboundedInt{ context.fromResidue(result) }, (wideA + wideB) % wideModulus);
+
+        addition.subtract(result, x, y);
+        EXPECT_EQ(UnboundedInt{ context.fromResidue(result) }, (wideA + wideModulus - wideB) % wideModulus);
+
+        addition.halve(result, x);
+        EXPECT_EQ(UnboundedInt{ context.fromResidue(result) } * 2 % wideModulus, wideA);
+
+        EXPECT_EQ(addition.isZero(x), a == 0);
+    }
+}
+
+TEST(ModularContext, residueAddition)
+{
+    testResidueAddition<WordMontgomeryContext<Uint64>>(std::numeric_limits<Uint64>::max() - 58, 200);
+    testResidueAddition<WordMontgomeryContext<Uint32>>(4294967291u, 200);
+    testResidueAddition<DivisionContext<Uint64>>(std::numeric_limits<Uint64>::max(), 200);
+    testResidueAddition<DivisionContext<Uint512>>(Uint512{ 1 } << 511 | 12345, 200);
+
+    const UnboundedInt modulus = (UnboundedInt{ 1 } << 1023) + 1155;
+    testResidueAddition<MontgomeryContext<UnboundedInt>>(modulus, 200);
+    testResidueAddition<BarrettContext<UnboundedInt>>(modulus, 200);
+    testResidueAddition<MontgomeryContext<Uint1024>>(Uint1024{ modulus }, 200);
+    testResidueAddition<BarrettContext<UnboundedInt>>((UnboundedInt{ 1 } << 64) - 59, 200);
+}
+
+// Counts multiplications of the wrapped context
+template <class Context>
+struct CountingContext {
+    using Value   = typename Context::Value;
+    using Residue = typename Context::Residue;
+
+    const Residue& one() const
+    {
+        return context.one();
+    }
+
+    void multiply(Residue& result, const Residue& a, const Residue& b) const
+    {
+        ++multiplications;
+        context.multiply(result, a, b);
+    }
+
+    Residue multiply(const Residue& a, const Residue& b) const
+    {
+        ++multiplications;
+        return context.multiply(a, b);
+    }
+
+    Context context;
+    mutable std::size_t multiplications = 0;
+};
+
+TEST(ModularContext, slidingWindowMatchesBinary)
+{
+    Mt19937RandomGenerator<1024, Uint1024> randomGenerator{};
+
+    MontgomeryContext<Uint1024> context{ randomGenerator() | 1 };
+    auto base = context.toResidue(randomGenerator());
+
+    for (Uint32 expBits : { 1, 2, 7, 24, 25, 80, 81, 240, 241, 672, 673, 1024 }) {
+        Uint1024 exp = randomGenerator() >> (1024 - expBits);
+        exp |= Uint1024{ 1 } << (expBits - 1);
+
+        auto expected = detail::binaryPower(context, base, exp);
+        for (Uint32 windowBits = 2; windowBits <= 7; ++windowBits) {
+            EXPECT_EQ(detail::slidingWindowPower(context, base, exp, windowBits), expected);
+        }
+        EXPECT_EQ(context.power(base, exp), expected);
+    }
+
+    EXPECT_EQ(detail::slidingWindowPower(context, base, Uint1024{ 0 }, 4), context.one());
+}
+
+TEST(ModularContext, slidingWindowSavesMultiplications)
+{
+    Mt19937RandomGenerator<2048, UnboundedInt> randomGenerator{};
+
+    CountingContext<DivisionContext<UnboundedInt>> context{ DivisionContext<UnboundedInt>{ randomGenerator() } };
+    auto base = context.context.toResidue(randomGenerator());
+
+    UnboundedInt exp = randomGenerator() | (UnboundedInt{ 1 } << 2047);
+
+    detail::binaryPower(context, base, exp);
+    const std::size_t binary = std::exchange(context.multiplications, 0);
+
+    detail::power(context, base, exp);
+    const std::size_t window = context.multiplications;
+
+    // 2047 squarings in both, about 1024 against about 300 other multiplications
+    EXPECT_LT(window, binary * 9 / 10);
+}
+
+
+template <Uint32 bitness, typename Value = typename ContainerByBitness<bitness>::Type>
+void testFixedBaseExponentiator(Uint32 rows, Uint32 columns, std::size_t testsAmount)
+{
+    Mt19937RandomGenerator<bitness, Value> randomGenerator{};
+
+    Value modulus = randomGenerator() | 1 | (Value{ 1 } << (bitness - 1));
+    Value base    = randomGenerator();
+
+    FixedBaseExponentiator<Value> exponentiator{ base, modulus, bitness, rows, columns };
+
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        Value exp = randomGenerator() >> (i % bitness);
+        EXPECT_EQ(exponentiator.modexp(exp), modexp(base, exp, modulus));
+    }
+
+    EXPECT_EQ(exponentiator.modexp(Value{ 0 }), 1);
+    EXPECT_EQ(exponentiator.modexp(Value{ 1 }), base % modulus);
+
+    // Longer exponents than the table covers fall back to plain exponentiation
+    UnboundedInt longExp = (UnboundedInt{ randomGenerator() } << bitness) | randomGenerator();
+    EXPECT_EQ(UnboundedInt{ exponentiator.modexp(longExp) },
+              modexp(UnboundedInt{ base }, longExp, UnboundedInt{ modulus }));
+}
+
+TEST(FixedBaseExponentiator, matchesModexp)
+{
+    testFixedBaseExponentiator<16>(8, 2, 200);
+    testFixedBaseExponentiator<61>(4, 3, 200);
+    testFixedBaseExponentiator<64>(8, 2, 200);
+    testFixedBaseExponentiator<127>(5, 1, 100);
+    testFixedBaseExponentiator<512>(8, 2, 50);
+    testFixedBaseExponentiator<1024>(6, 5, 20);
+    testFixedBaseExponentiator<2048>(8, 2, 5);
+}
+
+// Largest count odd primes below 2^64
+inline std::vector<Limb> wordPrimes(std::size_t count)
+{
+    std::vector<Limb> primes{};
+    for (Limb candidate = std::numeric_limits<Limb>::max(); primes.size() < count; candidate -= 2) {
+        if (deterministicMillerRabinTest(candidate))
+            primes.push_back(candidate);
+    }
+    return primes;
+}
+
+inline void testResidueNumberSystem(const std::vector<Limb>& moduli, std::size_t testsAmount)
+{
+    ResidueNumberSystem rns{ moduli };
+    const UnboundedInt& modulus = rns.modulus();
+
+    Mt19937RandomGenerator<64, UnboundedInt> randomGenerator{};
+    const auto random = [&] {
+        UnboundedInt number = 0;
+        for (std::size_t i = 0; i <= moduli.size(); ++i) {
+            number = (number << 64) | randomGenerator();
+        }
+        return number % modulus;
+    };
+
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        const UnboundedInt a = random(), b = random();
+        const auto x = rns.toResidue(a), y = rns.toResidue(b);
+
+        EXPECT_EQ(rns.fromResidue(x), a);
+        EXPECT_EQ(rns.channelValue(x, i % moduli.size()), a % moduli[i % moduli.size()]);
+
+        ResidueNumberSystem::Residue result{};
+        rns.add(result, x, y);
+        EXPECT_EQ(rns.fromResidue(result), (a + b) % modulus);
+        rns.subtract(result, x, y);
+        EXPECT_EQ(rns.fromResidue(result), (a - b + modulus) % modulus);
+        EXPECT_EQ(rns.fromResidue(rns.multiply(x, y)), a * b % modulus);
+
+        // Numbers past the modulus and negative ones wrap
+        EXPECT_EQ(rns.fromResidue(rns.toResidue(a * modulus + b)), b);
+        EXPECT_EQ(rns.fromResidue(rns.toResidue(UnboundedInt{ -a })), (modulus - a) % modulus);
+    }
+
+    const UnboundedInt base = random(), exp = random();
+    EXPECT_EQ(rns.modexp(base, exp), modexp(base, exp, modulus));
+    EXPECT_EQ(rns.fromResidue(rns.one()), 1);
+    EXPECT_EQ(rns.fromResidue(rns.toResidue(UnboundedInt{ 0 })), 0);
+    EXPECT_EQ(rns.fromResidue(rns.toResidue(modulus - 1)), modulus - 1);
+}
+
+TEST(ResidueNumberSystem, matchesUnboundedArithmetic)
+{
+    testResidueNumberSystem({ 3 }, 20);
+    testResidueNumberSystem({ 3, 5, 7, 11, 13 }, 100);
+    testResidueNumberSystem({ 0x3A00000000000001, 0x2280000000000001, 0x1B00000000000001 }, 200);
+    testResidueNumberSystem(wordPrimes(16), 100);
+    testResidueNumberSystem(wordPrimes(64), 20);
+
+    // Coprime, not prime
+    testResidueNumberSystem({ 9, 25, 49, std::numeric_limits<Limb>::max() - 2 }, 100);
+}
+
+TEST(ResidueNumberSystem, invalidModuli)
+{
+    EXPECT_THROW(ResidueNumberSystem{ std::vector<Limb>{} }, std::domain_error);
+    EXPECT_THROW((ResidueNumberSystem{ { 3, 4 } }), std::domain_error);
+    EXPECT_THROW((ResidueNumberSystem{ { 1, 3 } }), std::domain_error);
+    EXPECT_THROW((ResidueNumberSystem{ { 3, 5, 21 } }), std::domain_error);
+}
\ No newline at end of file
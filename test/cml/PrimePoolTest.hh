@@ -0,0 +1,246 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cml/cml.hh>
+
+using namespace cml;
+
+using PoolGenerator = MilRabPrimeGenerator<64, Mt19937RandomGenerator<64, Uint64>, Uint64>;
+
+// Hands out one fixed prime, and on a thread that closed the gate waits for it to open first
+class GatedGenerator : public PrimeGenerator<Uint64> {
+public:
+    static thread_local bool gated;
+    static std::atomic<bool> open;
+
+private:
+    Result generate() override
+    {
+        while (gated && !open) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+        return 0xFFFFFFFFFFFFFFC5ull;
+    }
+};
+
+thread_local bool GatedGenerator::gated = false;
+std::atomic<bool> GatedGenerator::open{ false };
+
+// Hands out one fixed prime. Background threads wait for the release, so the queue stays empty, while
+// threads that generate inline wait up to ten seconds for each other to arrive
+class RendezvousGenerator : public PrimeGenerator<Uint64> {
+public:
+    static constexpr int callers = 3;
+
+    static std::atomic<bool> released;
+    static std::atomic<int> arrived;
+    static std::atomic<int> met;
+    static thread_local bool caller;
+
+private:
+    Result generate() override
+    {
+        if (!caller) {
+            while (!released) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+            }
+        }
+        else {
+            ++arrived;
+            for (int i = 0; i < 10000 && arrived < callers; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+            }
+            if (arrived >= callers)
+                ++met;
+        }
+        return 0xFFFFFFFFFFFFFFC5ull;
+    }
+};
+
+std::atomic<bool> RendezvousGenerator::released{ false };
+std::atomic<int> RendezvousGenerator::arrived{ 0 };
+std::atomic<int> RendezvousGenerator::met{ 0 };
+thread_local bool RendezvousGenerator::caller = false;
+
+// Waits up to a minute for the background threads to reach depth
+template <class Pool>
+bool waitForDepth(const Pool& pool, std::size_t depth)
+{
+    for (int i = 0; i < 6000 && pool.metrics().depth < depth; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+    }
+    return pool.metrics().depth >= depth;
+}
+
+TEST(PrimePool, boundedMpmcQueue)
+{
+    detail::BoundedMpmcQueue<int> queue{ 5 };
+    EXPECT_EQ(queue.capacity(), 8u);
+
+    int value = 0;
+    EXPECT_FALSE(queue.pop(value));
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(value));
+    EXPECT_EQ(queue.size(), 8u);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(queue.size(), 0u);
+
+    // Producers and consumers at once, every value comes out exactly once
+    constexpr int perProducer = 20000;
+    detail::BoundedMpmcQueue<int> shared{ 64 };
+    std::vector<std::atomic<int>> seen(4 * perProducer);
+    std::atomic<int> consumed{ 0 };
+
+    std::vector<std::thread> threads{};
+    for (int producer = 0; producer < 4; ++producer) {
+        threads.emplace_back([&, producer] {
+            for (int i = producer * perProducer; i < (producer + 1) * perProducer; ++i) {
+                int item = i;
+                while (!shared.push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int consumer = 0; consumer < 4; ++consumer) {
+        threads.emplace_back([&] {
+            int item = 0;
+            while (consumed < 4 * perProducer) {
+                if (shared.pop(item)) {
+                    ++seen[item];
+                    ++consumed;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const std::atomic<int>& count : seen) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(PrimePool, servesPrimes)
+{
+    static_assert(IsPrimeGenerator<PrimePool<PoolGenerator>>::value);
+
+    PrimePool<PoolGenerator> pool{ 4, 16, 2 };
+    ASSERT_TRUE(waitForDepth(pool, 16));
+
+    PrimePoolMetrics metrics = pool.metrics();
+    EXPECT_GE(metrics.pooled, 16u);
+    EXPECT_EQ(metrics.workerCount, 2u);
+    EXPECT_GT(metrics.refillRate(), 0);
+
+    // More requests than the pool holds, the rest are generated inline or refilled meanwhile
+    for (int i = 0; i < 40; ++i) {
+        const Uint64 prime = pool(i % 2 == 0 ? LaunchPolicy::Sync : LaunchPolicy::Async);
+        EXPECT_EQ(bitLength(prime), 64u);
+        EXPECT_TRUE(isPrime64(prime)) << prime;
+    }
+    metrics = pool.metrics();
+    EXPECT_EQ(metrics.served + metrics.generatedInline, 40u);
+    EXPECT_GE(metrics.served, 16u);
+
+    // A request that leaves fewer than the low watermark starts a refill up to the high one
+    while (pool.metrics().depth >= 4) {
+        pool();
+    }
+    EXPECT_TRUE(waitForDepth(pool, 16));
+
+    // Several consumers at once
+    std::vector<std::thread> consumers{};
+    std::atomic<int> failures{ 0 };
+    for (int consumer = 0; consumer < 4; ++consumer) {
+        consumers.emplace_back([&] {
+            for (int i = 0; i < 10; ++i) {
+                if (!isPrime64(pool()))
+                    ++failures;
+            }
+        });
+    }
+    for (std::thread& consumer : consumers) {
+        consumer.join();
+    }
+    EXPECT_EQ(failures, 0);
+
+    EXPECT_THROW((PrimePool<PoolGenerator>{ 0, 4 }), std::domain_error);
+    EXPECT_THROW((PrimePool<PoolGenerator>{ 5, 4 }), std::domain_error);
+    EXPECT_THROW((PrimePool<PoolGenerator>{ 2, 4, 0 }), std::domain_error);
+}
+
+TEST(PrimePool, inlineGenerationHoldsUpNoRequest)
+{
+    PrimePool<GatedGenerator> pool{ 1, 2, 1 };
+
+    // A caller that empties the queue and then waits in an inline generation
+    std::thread caller{ [&] {
+        GatedGenerator::gated = true;
+        const Uint64 before   = pool.metrics().generatedInline;
+        while (pool.metrics().generatedInline == before) {
+            pool(LaunchPolicy::Async);
+        }
+    } };
+    while (pool.metrics().generatedInline == 0) {
+        std::this_thread::yield();
+    }
+
+    // Meanwhile requests with any launch policy are served
+    std::future<Uint64> async    = std::async(std::launch::async, [&] { return pool(LaunchPolicy::Async); });
+    std::future<Uint64> parallel = std::async(std::launch::async, [&] { return pool(LaunchPolicy::Parallel); });
+    EXPECT_EQ(async.wait_for(std::chrono::seconds{ 10 }), std::future_status::ready);
+    EXPECT_EQ(parallel.wait_for(std::chrono::seconds{ 10 }), std::future_status::ready);
+
+    GatedGenerator::open = true;
+    caller.join();
+    EXPECT_EQ(async.get(), 0xFFFFFFFFFFFFFFC5ull);
+    EXPECT_EQ(parallel.get(), 0xFFFFFFFFFFFFFFC5ull);
+}
+
+TEST(PrimePool, concurrentInlineGenerations)
+{
+    PrimePool<RendezvousGenerator> pool{ 1, 1, 1 };
+
+    // Requests on an empty pool, each generating inline, all in progress at once
+    std::vector<std::future<Uint64>> requests{};
+    for (int i = 0; i < RendezvousGenerator::callers; ++i) {
+        const LaunchPolicy policy = i % 2 == 0 ? LaunchPolicy::Async : LaunchPolicy::Parallel;
+        requests.push_back(std::async(std::launch::async, [&pool, policy] {
+            RendezvousGenerator::caller = true;
+            return pool(policy);
+        }));
+    }
+    for (std::future<Uint64>& request : requests) {
+        EXPECT_EQ(request.get(), 0xFFFFFFFFFFFFFFC5ull);
+    }
+    EXPECT_EQ(RendezvousGenerator::met, RendezvousGenerator::callers);
+    EXPECT_EQ(pool.metrics().generatedInline, static_cast<Uint64>(RendezvousGenerator::callers));
+
+    RendezvousGenerator::released = true;
+}
+
+TEST(PrimePool, rsaProtocol)
+{
+    using Value = typename ContainerByBitness<256>::Type;
+    RsaProtocol<PrimePool<MilRabPrimeGenerator<256, Mt19937RandomGenerator<256, Value>, Value>>> rsa{};
+    rsa.generate();
+
+    const std::vector<Uint64> message{ 'p', 'o', 'o', 'l' };
+    EXPECT_EQ(rsa.decrypt(rsa.encrypt(message, rsa.publicKey)), message);
+}
\ No newline at end of file
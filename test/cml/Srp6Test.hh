@@ -59,7 +59,7 @@ void testSrp6(const SecurityBase& securityBase,
 }
 
 template <Uint32 bitness>
-void multipleSrp6Tests(std::size_t testsAmount, bool print = false)
+void multipleSrp6Tests(std::size_t testsAmount, bool print = false, bool precompute = false)
 {
     using Value              = typename ContainerByBitness<bitness>::Type;
     using RandomGenerator    = Mt19937RandomGenerator<bitness, Value>;
@@ -72,6 +72,9 @@ void multipleSrp6Tests(std::size_t testsAmount, bool print = false)
 
     SecurityBase securityBase = SecurityBase::create(safePrimeGenerator, randomGenerator);
 
+    if (precompute)
+        securityBase.precompute();
+
     if (print) {
         std::cout << "Security base [N]: " << securityBase.N << std::endl;
         std::cout << "Security base [g]: " << securityBase.g << std::endl;
@@ -111,4 +114,39 @@ TEST(Srp6Protocol, InWork_50_x100)
     bool print               = false;
 
     multipleSrp6Tests<bitness>(testsAmount, print);
+}
+
+TEST(Srp6Protocol, InWork_Precomputed_50_x100)
+{
+    constexpr Uint32 bitness = 50;
+    std::size_t testsAmount  = 100;
+    bool print               = false;
+    bool precompute          = true;
+
+    multipleSrp6Tests<bitness>(testsAmount, print, precompute);
+}
+
+TEST(Srp6Protocol, InWork_LaunchPolicies_50)
+{
+    constexpr Uint32 bitness = 50;
+    using Value              = typename ContainerByBitness<bitness>::Type;
+    using RandomGenerator    = Mt19937RandomGenerator<bitness, Value>;
+    using PrimeGenerator     = MilRabPrimeGenerator<bitness, RandomGenerator, Value>;
+    using SafePrimeGenerator = MilRabSafePrimeGenerator<PrimeGenerator, RandomGenerator, Value>;
+    using SecurityBase       = Srp6SecurityBase<Value>;
+
+    SafePrimeGenerator safePrimeGenerator{};
+    RandomGenerator randomGenerator{};
+
+    for (LaunchPolicy policy : { LaunchPolicy::Sync, LaunchPolicy::Async, LaunchPolicy::Parallel }) {
+        const SecurityBase securityBase  = SecurityBase::create(safePrimeGenerator, randomGenerator, policy);
+        const SecurityBase securityBaseA = SecurityBase::createA<SafePrimeGenerator, RandomGenerator>(policy);
+        EXPECT_EQ(securityBase.k, 3);
+        EXPECT_EQ(securityBaseA.k, srp6Hash(securityBaseA.N, securityBaseA.g));
+
+        for (const SecurityBase& base : { securityBase, securityBaseA }) {
+            EXPECT_NE(base.g, 0);
+            testSrp6<bitness, Value>(base, randomGenerator, safePrimeGenerator);
+        }
+    }
 }
\ No newline at end of file
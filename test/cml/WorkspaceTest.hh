@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include <cml/cml.hh>
+
+using namespace cml;
+
+// Allocations of the calling thread so far, counted by the allocation functions of AllocationCounter.cc
+std::size_t threadAllocationCount();
+
+template <Uint32 bitness>
+void testWorkspaceSteadyState(std::size_t testsAmount)
+{
+    Mt19937RandomGenerator<bitness, UnboundedInt> randomGenerator{};
+
+    const UnboundedInt modulus = randomGenerator() | 1 | (UnboundedInt{ 1 } << (bitness - 1));
+    std::vector<UnboundedInt> bases{}, exps{};
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        bases.push_back(randomGenerator() % modulus);
+        exps.push_back(randomGenerator());
+    }
+
+    Workspace<UnboundedInt> workspace{};
+    UnboundedInt result{};
+
+    // The first call grows the buffers
+    modexp(result, bases[0], exps[0], modulus, workspace);
+    modmul(result, bases[0], exps[0], modulus, workspace);
+
+    // The counter sees the allocations of this thread, the overload without a workspace makes some
+    const std::size_t counted = threadAllocationCount();
+    result                    = modexp(bases[0], exps[0], modulus);
+    EXPECT_GT(threadAllocationCount(), counted);
+
+    for (std::size_t i = 0; i < testsAmount; ++i) {
+        const std::size_t before = threadAllocationCount();
+        modexp(result, bases[i], exps[i], modulus, workspace);
+        const std::size_t after = threadAllocationCount();
+
+        EXPECT_EQ(after, before);
+        EXPECT_EQ(result, modexp(bases[i], exps[i], modulus));
+    }
+
+    for (std::size_t i = 0; i + 1 < testsAmount; ++i) {
+        const std::size_t before = threadAllocationCount();
+        modmul(result, bases[i], bases[i + 1], modulus, workspace);
+        const std::size_t after = threadAllocationCount();
+
+        EXPECT_EQ(after, before);
+        EXPECT_EQ(result, bases[i] * bases[i + 1] % modulus);
+    }
+}
+
+TEST(Workspace, steadyStateDoesNotAllocate_512)
+{
+    testWorkspaceSteadyState<512>(20);
+}
+
+TEST(Workspace, steadyStateDoesNotAllocate_2048)
+{
+    testWorkspaceSteadyState<2048>(5);
+}
+
+TEST(Workspace, moduliAndAliasing)
+{
+    Workspace<UnboundedInt> workspace{};
+    UnboundedInt result{};
+
+    // Another odd modulus rebuilds the context, an even one falls back to division
+    for (UnboundedInt modulus : { UnboundedInt{ 1000003 }, UnboundedInt{ 1000004 }, UnboundedInt{ 1 },
+                                  (UnboundedInt{ 1 } << 127) - 1 }) {
+        modexp(result, UnboundedInt{ 12345 }, UnboundedInt{ 67890 }, modulus, workspace);
+        EXPECT_EQ(result, modexp(UnboundedInt{ 12345 }, UnboundedInt{ 67890 }, modulus));
+
+        modmul(result, UnboundedInt{ 12345 }, UnboundedInt{ modulus + 3 }, modulus, workspace);
+        EXPECT_EQ(result, UnboundedInt{ 12345 } * (modulus + 3) % modulus);
+    }
+
+    UnboundedInt number = 3;
+    modexp(number, number, UnboundedInt{ 5 }, UnboundedInt{ 1000003 }, workspace);
+    EXPECT_EQ(number, 243);
+    modmul(number, number, number, UnboundedInt{ 1000003 }, workspace);
+    EXPECT_EQ(number, 243 * 243);
+}
\ No newline at end of file
@@ -7,8 +7,11 @@
 
 #include "AlgorithmsTest.hh"
 #include "DiffieHellmanTest.hh"
+#include "ModularContextTest.hh"
+#include "PrimePoolTest.hh"
 #include "RsaTest.hh"
 #include "Srp6Test.hh"
+#include "WorkspaceTest.hh"
 
 int main(int argc, char *argv[])
 {